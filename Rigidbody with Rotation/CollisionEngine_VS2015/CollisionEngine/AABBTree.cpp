@@ -0,0 +1,64 @@
+#include "AABBTree.h"
+
+#include <algorithm>
+
+void	CAABBTree::Build(const std::vector<AABB>& bounds)
+{
+	m_nodes.clear();
+	if (bounds.empty())
+	{
+		return;
+	}
+
+	std::vector<size_t> leaves(bounds.size());
+	for (size_t i = 0; i < leaves.size(); ++i)
+	{
+		leaves[i] = i;
+	}
+	m_nodes.reserve(2 * leaves.size());
+	BuildNode(bounds, leaves.data(), leaves.size());
+}
+
+void	CAABBTree::Clear()
+{
+	m_nodes.clear();
+}
+
+bool	CAABBTree::IsEmpty() const
+{
+	return m_nodes.empty();
+}
+
+size_t	CAABBTree::BuildNode(const std::vector<AABB>& bounds, size_t* leaves, size_t count)
+{
+	size_t nodeIndex = m_nodes.size();
+	m_nodes.push_back(SNode());
+
+	AABB nodeBounds = bounds[leaves[0]];
+	for (size_t i = 1; i < count; ++i)
+	{
+		nodeBounds.Extend(bounds[leaves[i]].min);
+		nodeBounds.Extend(bounds[leaves[i]].max);
+	}
+	m_nodes[nodeIndex].bounds = nodeBounds;
+
+	if (count == 1)
+	{
+		m_nodes[nodeIndex].leaf = leaves[0];
+		return nodeIndex;
+	}
+
+	// Median split of the centers on the longest axis keeps the tree balanced
+	bool splitX = (nodeBounds.max.x - nodeBounds.min.x) >= (nodeBounds.max.y - nodeBounds.min.y);
+	size_t half = count / 2;
+	std::nth_element(leaves, leaves + half, leaves + count, [&](size_t a, size_t b)
+	{
+		Vec2 centerA = bounds[a].min + bounds[a].max;
+		Vec2 centerB = bounds[b].min + bounds[b].max;
+		return splitX ? centerA.x < centerB.x : centerA.y < centerB.y;
+	});
+
+	BuildNode(bounds, leaves, half);
+	m_nodes[nodeIndex].right = BuildNode(bounds, leaves + half, count - half);
+	return nodeIndex;
+}
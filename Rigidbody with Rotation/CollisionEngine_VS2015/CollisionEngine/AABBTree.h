@@ -0,0 +1,67 @@
+#ifndef _AABB_TREE_H_
+#define _AABB_TREE_H_
+
+#include <vector>
+
+#include "Maths.h"
+
+// Traversal stack, far more than a median split tree of any size needs
+#define AABB_TREE_STACK_SIZE	64
+
+// Bounding volume tree built once over a set of boxes, for things that don't move
+// Leaves are the indices of the boxes given to Build()
+class CAABBTree
+{
+public:
+	void	Build(const std::vector<AABB>& bounds);
+	void	Clear();
+	bool	IsEmpty() const;
+
+	// functor(index) for each box overlapping box
+	template<typename TFunctor>
+	void	ForEachOverlap(const AABB& box, TFunctor functor) const
+	{
+		if (m_nodes.empty())
+		{
+			return;
+		}
+
+		size_t stack[AABB_TREE_STACK_SIZE];
+		size_t stackSize = 0;
+		stack[stackSize++] = 0;
+		while (stackSize > 0)
+		{
+			size_t nodeIndex = stack[--stackSize];
+			const SNode& node = m_nodes[nodeIndex];
+			if (!node.bounds.Intersect(box))
+			{
+				continue;
+			}
+
+			if (node.right == 0)
+			{
+				functor(node.leaf);
+			}
+			else
+			{
+				stack[stackSize++] = node.right;
+				stack[stackSize++] = nodeIndex + 1;
+			}
+		}
+	}
+
+private:
+	// Left child is the next node, leaves have no right child
+	struct SNode
+	{
+		AABB	bounds;
+		size_t	leaf = 0;
+		size_t	right = 0;
+	};
+
+	size_t	BuildNode(const std::vector<AABB>& bounds, size_t* leaves, size_t count);
+
+	std::vector<SNode>	m_nodes;
+};
+
+#endif
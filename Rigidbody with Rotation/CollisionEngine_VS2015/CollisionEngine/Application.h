@@ -3,19 +3,48 @@
 
 #include "GlobalVariables.h"
 #include "SDLRenderWindow.h"
+#include "OffscreenRenderWindow.h"
+#include "GLRenderBackend.h"
+#include "SoftwareRenderBackend.h"
 #include "PhysicEngine.h"
 #include "Renderer.h"
 #include "SceneManager.h"
 #include "World.h"
+#include "ThreadPool.h"
+#include "PhysicThread.h"
 
 void InitApplication(int width, int height, float worldHeight)
 {
 	gVars = new SGlobalVariables();
 
 	gVars->pRenderWindow = new CSDLRenderWindow(width, height);
-	gVars->pRenderer = new CRenderer(worldHeight);
+	gVars->pRenderer = new CRenderer(worldHeight, new COpenGLRenderBackend());
 	gVars->pSceneManager = new CSceneManager();
 	gVars->pPhysicEngine = new CPhysicEngine();
+	gVars->pThreadPool = new CThreadPool();
+	gVars->pPhysicThread = new CPhysicThread();
+
+	// While the FPS are locked, the main thread helps the physic thread jobs instead of only sleeping
+	gVars->pRenderer->GetFramePacer().SetIdleJob([](float idleTime)
+	{
+		return gVars->pThreadPool->Assist(idleTime);
+	});
+
+	gVars->bDebug = false;
+}
+
+// No window nor GPU, frames are rasterized on the CPU
+void InitOffscreenApplication(int width, int height, float worldHeight, const SOffscreenParams& params)
+{
+	gVars = new SGlobalVariables();
+
+	CSoftwareRenderBackend* backend = new CSoftwareRenderBackend();
+	gVars->pRenderWindow = new COffscreenRenderWindow(width, height, backend, params);
+	gVars->pRenderer = new CRenderer(worldHeight, backend);
+	gVars->pSceneManager = new CSceneManager();
+	gVars->pPhysicEngine = new CPhysicEngine();
+	gVars->pThreadPool = new CThreadPool();
+	gVars->pPhysicThread = new CPhysicThread();
 
 	gVars->bDebug = false;
 }
@@ -0,0 +1,55 @@
+#include "BatchRenderer.h"
+
+CBatchRenderer::CBatchRenderer()
+	: m_vertexBuffer(GL_ARRAY_BUFFER)
+{
+}
+
+CBatchRenderer::~CBatchRenderer()
+{
+	if (m_indexBufferId != 0)
+	{
+		glDeleteBuffers(1, &m_indexBufferId);
+	}
+}
+
+void	CBatchRenderer::Draw(const CPolygonBatch& batch, float r, float g, float b)
+{
+	if (batch.GetIndexCount() == 0)
+	{
+		return;
+	}
+
+	const std::vector<Vec2>& vertices = batch.GetVertices();
+	size_t offset = m_vertexBuffer.Upload(vertices.data(), sizeof(Vec2) * vertices.size());
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glVertexPointer(2, GL_FLOAT, 0, (void*)offset);
+
+	if (m_indexBufferId == 0)
+	{
+		glGenBuffers(1, &m_indexBufferId);
+	}
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBufferId);
+
+	// Indices only change when polygons are added or removed, whichever snapshot the batch comes from
+	if (m_topologyHash != batch.GetTopologyHash() || m_indexCount != batch.GetIndexCount())
+	{
+		m_indexCount = batch.GetIndexCount();
+		m_topologyHash = batch.GetTopologyHash();
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint32_t) * m_indexCount, batch.GetIndices(), GL_STATIC_DRAW);
+	}
+
+	glPushMatrix();
+	glTranslatef(0.0f, 0.0f, -1.0f);
+	glColor3f(r, g, b);
+
+	glDrawElements(GL_LINES, (GLsizei)batch.GetIndexCount(), GL_UNSIGNED_INT, (void*)0);
+
+	glPopMatrix();
+
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	m_vertexBuffer.EndFrame();
+}
@@ -0,0 +1,29 @@
+#ifndef _BATCH_RENDERER_H_
+#define _BATCH_RENDERER_H_
+
+#include <GL/glew.h>
+
+#include "PolygonBatch.h"
+#include "StreamBuffer.h"
+
+// Draw a whole polygon batch with a single glDrawElements
+class CBatchRenderer
+{
+public:
+	CBatchRenderer();
+	~CBatchRenderer();
+
+	CBatchRenderer(const CBatchRenderer&) = delete;
+	CBatchRenderer& operator=(const CBatchRenderer&) = delete;
+
+	void	Draw(const CPolygonBatch& batch, float r, float g, float b);
+
+private:
+	CStreamBuffer	m_vertexBuffer;
+
+	GLuint		m_indexBufferId = 0;
+	uint64_t	m_topologyHash = 0; // of the uploaded indices
+	size_t		m_indexCount = 0;
+};
+
+#endif
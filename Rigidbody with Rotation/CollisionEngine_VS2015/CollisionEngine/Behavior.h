@@ -2,6 +2,7 @@
 #define _BEHAVIOR_H_
 
 #include "Polygon.h"
+#include "RenderSnapshot.h"
 
 class CBehavior
 {
@@ -17,6 +18,8 @@ public:
 
 	virtual void Start(){}
 	virtual void Update(float frameTime){}
+	// Called after the world polygons are added to the snapshot
+	virtual void FillSnapshot(SRenderSnapshot& snapshot){}
 
 private:
 	size_t	m_index = 0;
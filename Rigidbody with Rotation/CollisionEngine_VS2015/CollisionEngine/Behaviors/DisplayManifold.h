@@ -5,7 +5,7 @@
 #include "PhysicEngine.h"
 #include "GlobalVariables.h"
 #include "Renderer.h"
-#include "RenderWindow.h"
+#include "PhysicThread.h"
 #include "World.h"
 
 #include <string>
@@ -25,8 +25,11 @@ private:
 		//DrawCollisionPolygon(polyA);
 		//DrawCollisionPolygon(polyB);
 
-		gVars->pRenderer->DisplayTextWorld("A", polyA->position);
-		gVars->pRenderer->DisplayTextWorld("B", polyB->position);
+		const SInputState& input = gVars->pPhysicThread->GetInput();
+		Vec2 screenPosA = input.WorldToScreenPos(polyA->position);
+		Vec2 screenPosB = input.WorldToScreenPos(polyB->position);
+		gVars->pRenderer->DisplayText("A", (int)screenPosA.x, (int)screenPosA.y);
+		gVars->pRenderer->DisplayText("B", (int)screenPosB.x, (int)screenPosB.y);
 
 		Vec2 dir = Vec2(-1.0f, -0.5f).Normalized();
 		float dist = 100.0f;
@@ -48,7 +51,7 @@ private:
 
 			for (size_t i = 0; i < collision.manifoldSize; ++i)
 			{
-				gVars->pRenderer->DrawLine(collision.manifold[i].point, collision.manifold[i].point + collision.manifold[i].normal * collision.manifold[i].penetration, 0, 0, 1);
+				gVars->pRenderer->DrawLine(collision.manifold[i].point, collision.manifold[i].point + collision.manifold[i].normal * collision.manifold[i].penetration, 0, 0, 1, EDebugCategory::Contact);
 			}
 
 		//	Vec2 offset = normal * penetration;
@@ -58,23 +61,25 @@ private:
 
 	void DrawCollisionPolygon(CPolygonPtr poly)
 	{
-		for (size_t i = 0; i < poly->points.size(); ++i)
+		const TShapeArray<Vec2>& points = poly->GetPoints();
+		for (size_t i = 0; i < points.size(); ++i)
 		{
-			Vec2 pointA = poly->TransformPoint(poly->points[i] * 0.6f);
-			Vec2 pointB = poly->TransformPoint(poly->points[(i + 1) % poly->points.size()] * 0.6f);
+			Vec2 pointA = poly->TransformPoint(points[i] * 0.6f);
+			Vec2 pointB = poly->TransformPoint(points[(i + 1) % points.size()] * 0.6f);
 
-			gVars->pRenderer->DrawLine(pointA, pointB, 0, 1, 0);
+			gVars->pRenderer->DrawLine(pointA, pointB, 0, 1, 0, EDebugCategory::Contact);
 		}
 	}
 
 	void DrawGhostPolygon(CPolygonPtr poly, Vec2 offset)
 	{
-		for (size_t i = 0; i < poly->points.size(); ++i)
+		const TShapeArray<Vec2>& points = poly->GetPoints();
+		for (size_t i = 0; i < points.size(); ++i)
 		{
-			Vec2 pointA = poly->TransformPoint(poly->points[i]) + offset;
-			Vec2 pointB = poly->TransformPoint(poly->points[(i + 1) % poly->points.size()]) + offset;
+			Vec2 pointA = poly->TransformPoint(points[i]) + offset;
+			Vec2 pointB = poly->TransformPoint(points[(i + 1) % points.size()]) + offset;
 
-			gVars->pRenderer->DrawLine(pointA, pointB, 0, 1, 0);
+			gVars->pRenderer->DrawLine(pointA, pointB, 0, 1, 0, EDebugCategory::Contact);
 		}
 	}
 };
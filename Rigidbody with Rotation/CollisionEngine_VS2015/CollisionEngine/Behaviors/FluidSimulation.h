@@ -1,138 +1,303 @@
 #ifndef _FLUID_SIMULATION_H_
 #define _FLUID_SIMULATION_H_
 
+#include <emmintrin.h>
+
 #include "Behavior.h"
 #include "PhysicEngine.h"
 #include "GlobalVariables.h"
 #include "Renderer.h"
+#include "PhysicThread.h"
 #include "World.h"
+#include "NeighborGrid.h"
+#include "ThreadPool.h"
+
+#define FLUID_PARTICLE_SPACING	0.15f
+#define FLUID_SMOOTHING_RADIUS	(2.0f * FLUID_PARTICLE_SPACING)
+#define FLUID_REST_DENSITY		1.0f
+#define FLUID_STIFFNESS			1000.0f
+#define FLUID_VISCOSITY			0.5f
+#define FLUID_GRAVITY			20.0f
+#define FLUID_DAMPING			0.05f
+#define FLUID_WALL_DAMPING		0.5f
+#define FLUID_MAX_TIME_STEP		(1.0f / 240.0f)
 
-#define RADIUS 0.9f //2.0f
-#define DISTANCE 5.0f
+// Particles per thread pool job
+#define FLUID_CHUNK_SIZE		1024
 
-struct SCircle
+// Particle arrays, one float array per component
+struct SFluidParticles
 {
-	Vec2 pos, speed;
+	void Resize(size_t count)
+	{
+		for (std::vector<float>* component : { &posX, &posY, &speedX, &speedY, &density, &pressure })
+		{
+			component->resize(count);
+		}
+	}
+
+	size_t Size() const
+	{
+		return posX.size();
+	}
+
+	std::vector<float>	posX, posY;
+	std::vector<float>	speedX, speedY;
+	std::vector<float>	density, pressure;
 };
 
 
+// Weakly compressible SPH, neighbors found through a cell-linked grid
+// Particles are sorted by cell every step so neighbors are close in memory
+// Each pass is split over the thread pool, integration runs 4 particles at a time with SSE
 class CFluidSimulation: public CBehavior
 {
-private:
-
+public:
+	void SetParticleCount(size_t particleCount)
+	{
+		m_particleCount = particleCount;
+	}
 
+private:
 	virtual void Start() override
 	{
-		for (float x = -12.0f; x < 12.0f; x += 1.0f)
+		// Mass such that a particle at rest on the initial lattice has the rest density
+		float latticeDensity = 0.0f;
+		int range = (int)ceilf(FLUID_SMOOTHING_RADIUS / FLUID_PARTICLE_SPACING);
+		for (int x = -range; x <= range; ++x)
 		{
-			for (float y = -22.0f; y < 22.0f; y += 1.0f)
+			for (int y = -range; y <= range; ++y)
 			{
-				AddCircle(Vec2(x + Random(-0.1f, 0.1f), y + Random(-0.1f, 0.1f)));
+				float r = Vec2((float)x, (float)y).GetLength() * FLUID_PARTICLE_SPACING;
+				if (r < FLUID_SMOOTHING_RADIUS)
+				{
+					latticeDensity += KernelDefault(r, FLUID_SMOOTHING_RADIUS);
+				}
 			}
 		}
+		m_particleMass = FLUID_REST_DENSITY / latticeDensity;
+
+		// Block of fluid in the left half of the screen
+		float hWidth = gVars->pRenderer->GetWorldWidth() * 0.5f;
+		float hHeight = gVars->pRenderer->GetWorldHeight() * 0.5f;
+		size_t columns = (size_t)(hWidth / FLUID_PARTICLE_SPACING);
+
+		m_particles.Resize(m_particleCount);
+		for (size_t i = 0; i < m_particleCount; ++i)
+		{
+			m_particles.posX[i] = -hWidth + (0.5f + (float)(i % columns) + Random(-0.01f, 0.01f)) * FLUID_PARTICLE_SPACING;
+			m_particles.posY[i] = -hHeight + (0.5f + (float)(i / columns) + Random(-0.01f, 0.01f)) * FLUID_PARTICLE_SPACING;
+			m_particles.speedX[i] = 0.0f;
+			m_particles.speedY[i] = 0.0f;
+			m_particles.density[i] = FLUID_REST_DENSITY;
+			m_particles.pressure[i] = 0.0f;
+		}
 
 		gVars->pPhysicEngine->Activate(false);
 	}
 
 	virtual void Update(float frameTime) override
 	{
-		for (SCircle& circle : m_circles)
-		{
-			circle.speed.y -= 20.0f * frameTime;
-			circle.speed -= circle.speed * 0.3f * frameTime;
-		}
+		frameTime = Min(frameTime, 1.0f / 15.0f);
+		int stepCount = (int)ceilf(frameTime / FLUID_MAX_TIME_STEP);
+		float deltaTime = frameTime / (float)stepCount;
 
-		for (size_t i = 0; i < m_circles.size(); ++i)
+		for (int step = 0; step < stepCount; ++step)
 		{
-			for (size_t j = i + 1; j < m_circles.size(); ++j)
-			{
-				SCircle& c1 = m_circles[i];
-				SCircle& c2 = m_circles[j];
-
-				Vec2 diffPos = c2.pos - c1.pos;
-				Vec2 diffSpeed = c2.speed - c1.speed;
-				if (diffPos.GetSqrLength() < 4.0f * RADIUS * RADIUS && ((diffSpeed | diffPos) < 0.0f))
-				{
-					Vec2 normal = diffPos.Normalized();
-					Vec2 diff = normal * (diffSpeed | normal) * 0.5f;
+			SortParticles();
 
-					c1.speed += diff * 1.4f;
-					c2.speed -= diff * 1.4f;
-					//float colDist = 2.0f * RADIUS - diffPos.GetLength();
-
-					//c1->position -= normal * colDist * 0.5f;
-					//c2->position += normal * colDist * 0.5f;
-				}
-			}
+			gVars->pThreadPool->ParallelFor(m_particles.Size(), FLUID_CHUNK_SIZE, [&](size_t begin, size_t end)
+			{
+				ComputeDensities(begin, end);
+			});
+			gVars->pThreadPool->ParallelFor(m_particles.Size(), FLUID_CHUNK_SIZE, [&](size_t begin, size_t end)
+			{
+				ComputeAccelerations(begin, end);
+			});
+			gVars->pThreadPool->ParallelFor(m_particles.Size(), FLUID_CHUNK_SIZE, [&](size_t begin, size_t end)
+			{
+				Integrate(begin, end, deltaTime);
+			});
 		}
+	}
 
+	virtual void FillSnapshot(SRenderSnapshot& snapshot) override
+	{
+		snapshot.AddPoints(m_particles.posX.data(), m_particles.posY.data(), m_particles.Size(), FLUID_PARTICLE_SPACING * 0.5f, 0.2f, 0.5f, 0.9f);
+	}
 
+	void SortParticles()
+	{
+		m_grid.Build(m_particles.posX.data(), m_particles.posY.data(), m_particles.Size(), FLUID_SMOOTHING_RADIUS);
 
+		const std::vector<uint32_t>& sortedIndices = m_grid.GetSortedIndices();
+		m_sortedParticles.Resize(m_particles.Size());
 
-		float hWidth = gVars->pRenderer->GetWorldWidth() * 0.5f;
-		float hHeight = gVars->pRenderer->GetWorldHeight() * 0.5f;
+		// Density and pressure are recomputed from the positions
+		std::pair<std::vector<float>*, std::vector<float>*> components[] =
+		{
+			{ &m_particles.posX, &m_sortedParticles.posX },
+			{ &m_particles.posY, &m_sortedParticles.posY },
+			{ &m_particles.speedX, &m_sortedParticles.speedX },
+			{ &m_particles.speedY, &m_sortedParticles.speedY },
+		};
 
-		for (SCircle& circle : m_circles)
+		gVars->pThreadPool->ParallelFor(m_particles.Size(), FLUID_CHUNK_SIZE, [&](size_t begin, size_t end)
 		{
-			if (circle.pos.x < -hWidth && circle.speed.x < 0)
-			{
-				circle.speed.x *= -1.0f;
-			}
-			else if (circle.pos.x > hWidth && circle.speed.x > 0)
-			{
-				circle.speed.x *= -1.0f;
-			}
-			if (circle.pos.y < -hHeight && circle.speed.y < 0)
-			{
-				circle.speed.y *= -1.0f;
-			}
-			else if (circle.pos.y > hHeight && circle.speed.y > 0)
+			for (const auto& component : components)
 			{
-				circle.speed.y *= -1.0f;
+				const float* source = component.first->data();
+				float* destination = component.second->data();
+				for (size_t i = begin; i < end; ++i)
+				{
+					destination[i] = source[sortedIndices[i]];
+				}
 			}
-		}
+		});
+
+		std::swap(m_particles, m_sortedParticles);
+	}
+
+	void ComputeDensities(size_t begin, size_t end)
+	{
+		const float* posX = m_particles.posX.data();
+		const float* posY = m_particles.posY.data();
 
-		for (SCircle& circle : m_circles)
+		for (size_t i = begin; i < end; ++i)
 		{
-			circle.pos += circle.speed * frameTime;
-		}
+			float density = 0.0f;
+			m_grid.ForEachNeighborRange(posX[i], posY[i], [&](uint32_t neighborBegin, uint32_t neighborEnd)
+			{
+				for (uint32_t j = neighborBegin; j < neighborEnd; ++j)
+				{
+					float dx = posX[j] - posX[i];
+					float dy = posY[j] - posY[i];
+					float sqrDist = dx * dx + dy * dy;
+					if (sqrDist < FLUID_SMOOTHING_RADIUS * FLUID_SMOOTHING_RADIUS)
+					{
+						density += KernelDefault(sqrtf(sqrDist), FLUID_SMOOTHING_RADIUS);
+					}
+				}
+			});
 
-		UpdatePolys();
+			m_particles.density[i] = density * m_particleMass;
+			m_particles.pressure[i] = Max(FLUID_STIFFNESS * (m_particles.density[i] - FLUID_REST_DENSITY), 0.0f);
+		}
 	}
 
-	void AddCircle(const Vec2& pos, float radius = RADIUS)
+	// Pressure and viscosity, written to the sorted copy speeds as neighbors still read the current ones
+	void ComputeAccelerations(size_t begin, size_t end)
 	{
-		SCircle circle;
-		circle.pos = pos;
-		circle.speed.x = 50;
-	
+		const float* posX = m_particles.posX.data();
+		const float* posY = m_particles.posY.data();
+		const float* speedX = m_particles.speedX.data();
+		const float* speedY = m_particles.speedY.data();
+		const float* density = m_particles.density.data();
+		const float* pressure = m_particles.pressure.data();
 
+		for (size_t i = begin; i < end; ++i)
+		{
+			float accelerationX = 0.0f, accelerationY = 0.0f;
+			m_grid.ForEachNeighborRange(posX[i], posY[i], [&](uint32_t neighborBegin, uint32_t neighborEnd)
+			{
+				for (uint32_t j = neighborBegin; j < neighborEnd; ++j)
+				{
+					float dx = posX[i] - posX[j];
+					float dy = posY[i] - posY[j];
+					float sqrDist = dx * dx + dy * dy;
+					if (sqrDist >= FLUID_SMOOTHING_RADIUS * FLUID_SMOOTHING_RADIUS || j == i)
+					{
+						continue;
+					}
+					float r = Max(sqrtf(sqrDist), FLUID_SMOOTHING_RADIUS * 0.01f);
 
-		CPolygonPtr poly = gVars->pWorld->AddSymetricPolygon(radius, 3); // 5);
-		poly->density = 0.0f;
-		poly->position = pos;
-		poly->speed = circle.speed;
+					float invDensities = m_particleMass / (density[i] * density[j]);
+					float pressureFactor = 0.5f * (pressure[i] + pressure[j]) * invDensities * KernelSpikyGradientFactor(r, FLUID_SMOOTHING_RADIUS);
+					float viscosityFactor = FLUID_VISCOSITY * invDensities * KernelViscosityLaplacian(r, FLUID_SMOOTHING_RADIUS);
 
-		m_poly.push_back(poly);
-		m_circles.push_back(circle);
+					accelerationX += viscosityFactor * (speedX[j] - speedX[i]) - pressureFactor * dx;
+					accelerationY += viscosityFactor * (speedY[j] - speedY[i]) - pressureFactor * dy;
+				}
+			});
 
+			m_sortedParticles.speedX[i] = accelerationX;
+			m_sortedParticles.speedY[i] = accelerationY;
+		}
 	}
-	
-	void UpdatePolys()
+
+	// Gravity, damping, integration and wall bounce, 4 particles at a time
+	void Integrate(size_t begin, size_t end, float deltaTime)
 	{
-		for (size_t i = 0; i < m_circles.size(); ++i)
+		const SInputState& input = gVars->pPhysicThread->GetInput();
+		float hWidth = input.worldWidth * 0.5f;
+		float hHeight = input.worldHeight * 0.5f;
+
+		float* posX = m_particles.posX.data();
+		float* posY = m_particles.posY.data();
+		float* speedX = m_particles.speedX.data();
+		float* speedY = m_particles.speedY.data();
+		const float* accelerationX = m_sortedParticles.speedX.data();
+		const float* accelerationY = m_sortedParticles.speedY.data();
+
+		const __m128 dt = _mm_set1_ps(deltaTime);
+		const __m128 gravity = _mm_set1_ps(-FLUID_GRAVITY * deltaTime);
+		const __m128 damping = _mm_set1_ps(1.0f - FLUID_DAMPING * deltaTime);
+		const __m128 wallDamping = _mm_set1_ps(-FLUID_WALL_DAMPING);
+		const __m128 minX = _mm_set1_ps(-hWidth), maxX = _mm_set1_ps(hWidth);
+		const __m128 minY = _mm_set1_ps(-hHeight), maxY = _mm_set1_ps(hHeight);
+		const __m128 zero = _mm_setzero_ps();
+
+		size_t i = begin;
+		for (; i + 4 <= end; i += 4)
 		{
-			CPolygonPtr poly = m_poly[i];
-			SCircle& circle = m_circles[i];
+			__m128 vx = _mm_loadu_ps(speedX + i);
+			__m128 vy = _mm_loadu_ps(speedY + i);
+			vx = _mm_mul_ps(_mm_add_ps(vx, _mm_mul_ps(_mm_loadu_ps(accelerationX + i), dt)), damping);
+			vy = _mm_mul_ps(_mm_add_ps(_mm_add_ps(vy, _mm_mul_ps(_mm_loadu_ps(accelerationY + i), dt)), gravity), damping);
+
+			__m128 px = _mm_add_ps(_mm_loadu_ps(posX + i), _mm_mul_ps(vx, dt));
+			__m128 py = _mm_add_ps(_mm_loadu_ps(posY + i), _mm_mul_ps(vy, dt));
 
-			poly->position = circle.pos;
-			poly->speed = circle.speed;
+			// Walls : clamp position and bounce the speed going outside
+			__m128 bounceX = _mm_or_ps(_mm_and_ps(_mm_cmplt_ps(px, minX), _mm_cmplt_ps(vx, zero)), _mm_and_ps(_mm_cmpgt_ps(px, maxX), _mm_cmpgt_ps(vx, zero)));
+			__m128 bounceY = _mm_or_ps(_mm_and_ps(_mm_cmplt_ps(py, minY), _mm_cmplt_ps(vy, zero)), _mm_and_ps(_mm_cmpgt_ps(py, maxY), _mm_cmpgt_ps(vy, zero)));
+			vx = _mm_or_ps(_mm_and_ps(bounceX, _mm_mul_ps(vx, wallDamping)), _mm_andnot_ps(bounceX, vx));
+			vy = _mm_or_ps(_mm_and_ps(bounceY, _mm_mul_ps(vy, wallDamping)), _mm_andnot_ps(bounceY, vy));
+			px = _mm_min_ps(_mm_max_ps(px, minX), maxX);
+			py = _mm_min_ps(_mm_max_ps(py, minY), maxY);
+
+			_mm_storeu_ps(speedX + i, vx);
+			_mm_storeu_ps(speedY + i, vy);
+			_mm_storeu_ps(posX + i, px);
+			_mm_storeu_ps(posY + i, py);
+		}
+
+		for (; i < end; ++i)
+		{
+			speedX[i] = (speedX[i] + accelerationX[i] * deltaTime) * (1.0f - FLUID_DAMPING * deltaTime);
+			speedY[i] = (speedY[i] + accelerationY[i] * deltaTime - FLUID_GRAVITY * deltaTime) * (1.0f - FLUID_DAMPING * deltaTime);
+			posX[i] += speedX[i] * deltaTime;
+			posY[i] += speedY[i] * deltaTime;
+
+			if ((posX[i] < -hWidth && speedX[i] < 0.0f) || (posX[i] > hWidth && speedX[i] > 0.0f))
+			{
+				speedX[i] *= -FLUID_WALL_DAMPING;
+			}
+			if ((posY[i] < -hHeight && speedY[i] < 0.0f) || (posY[i] > hHeight && speedY[i] > 0.0f))
+			{
+				speedY[i] *= -FLUID_WALL_DAMPING;
+			}
+			posX[i] = Clamp(posX[i], -hWidth, hWidth);
+			posY[i] = Clamp(posY[i], -hHeight, hHeight);
 		}
 	}
 
+	size_t	m_particleCount = 50000;
+	float	m_particleMass = 1.0f;
 
-	std::vector<CPolygonPtr>	m_poly;
-	std::vector<SCircle>	m_circles;
+	CNeighborGrid	m_grid;
+	SFluidParticles	m_particles;
+	SFluidParticles	m_sortedParticles; // sort destination, then accelerations
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -4,38 +4,26 @@
 #include "Behavior.h"
 #include "PhysicEngine.h"
 #include "GlobalVariables.h"
-#include "Renderer.h"
-#include "RenderWindow.h"
+#include "PhysicThread.h"
 #include "World.h"
 
 class CPolygonMoverTool : public CBehavior
 {
 	CPolygonPtr	GetClickedPolygon()
 	{
-		Vec2 pt, n;
-		Vec2 mousePoint = gVars->pRenderer->ScreenToWorldPos(gVars->pRenderWindow->GetMousePos());
-		CPolygonPtr clickedPoly;
-
-		gVars->pWorld->ForEachPolygon([&](CPolygonPtr poly)
-		{
-			if (poly->IsPointInside(mousePoint))
-			{
-				clickedPoly = poly;
-			}
-		});
-
-		return clickedPoly;
+		return gVars->pWorld->QueryPoint(gVars->pPhysicThread->GetInput().mousePos);
 	}
 
 	virtual void Update(float frameTime) override
 	{
-		if (gVars->pRenderWindow->GetMouseButton(0) || gVars->pRenderWindow->GetMouseButton(2))
+		const SInputState& input = gVars->pPhysicThread->GetInput();
+		if (input.mouseButtons[0] || input.mouseButtons[2])
 		{
 			if (!m_selectedPoly)
 			{
 				m_selectedPoly = GetClickedPolygon();
-				m_prevMousePos = gVars->pRenderer->ScreenToWorldPos(gVars->pRenderWindow->GetMousePos());
-				m_translate = gVars->pRenderWindow->GetMouseButton(0);
+				m_prevMousePos = input.mousePos;
+				m_translate = input.mouseButtons[0];
 				m_clickMousePos = m_prevMousePos;
 
 				if (m_selectedPoly)
@@ -43,7 +31,7 @@ class CPolygonMoverTool : public CBehavior
 			}
 			else
 			{
-				Vec2 mousePoint = gVars->pRenderer->ScreenToWorldPos(gVars->pRenderWindow->GetMousePos());
+				Vec2 mousePoint = input.mousePos;
 
 				if (m_translate)
 				{
@@ -5,6 +5,7 @@
 #include "PhysicEngine.h"
 #include "GlobalVariables.h"
 #include "Renderer.h"
+#include "PhysicThread.h"
 #include "World.h"
 
 class CSimplePolygonBounce : public CBehavior
@@ -21,8 +22,9 @@ private:
 			collision.polyB->speed.Reflect(collision.normal);
 		});
 
-		float hWidth = gVars->pRenderer->GetWorldWidth() * 0.5f;
-		float hHeight = gVars->pRenderer->GetWorldHeight() * 0.5f;
+		const SInputState& input = gVars->pPhysicThread->GetInput();
+		float hWidth = input.worldWidth * 0.5f;
+		float hHeight = input.worldHeight * 0.5f;
 
 		gVars->pWorld->ForEachPolygon([&](CPolygonPtr poly)
 		{
@@ -5,6 +5,7 @@
 #include "PhysicEngine.h"
 #include "GlobalVariables.h"
 #include "Renderer.h"
+#include "PhysicThread.h"
 #include "World.h"
 
 #define RADIUS 2.0f
@@ -105,8 +106,9 @@ private:
 			}
 		}
 
-		float hWidth = gVars->pRenderer->GetWorldWidth() * 0.5f;
-		float hHeight = gVars->pRenderer->GetWorldHeight() * 0.5f;
+		const SInputState& input = gVars->pPhysicThread->GetInput();
+		float hWidth = input.worldWidth * 0.5f;
+		float hHeight = input.worldHeight * 0.5f;
 
 		for (CPolygonPtr& circle : m_circles)
 		{
@@ -138,7 +140,7 @@ private:
 
 	CPolygonPtr AddCircle(const Vec2& pos, float radius = RADIUS)
 	{
-		CPolygonPtr circle = gVars->pWorld->AddSymetricPolygon(radius, 50);
+		CPolygonPtr circle = gVars->pWorld->AddCircle(radius);
 		circle->density = 0.0f;
 		circle->position = pos;
 		m_circles.push_back(circle);
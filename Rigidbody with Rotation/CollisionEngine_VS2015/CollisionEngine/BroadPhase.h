@@ -6,7 +6,20 @@
 class IBroadPhase
 {
 public:
+	virtual ~IBroadPhase(){}
+
+	// Rebuild from the current polygon AABBs, done by each physic step
+	virtual void Update() = 0;
 	virtual void GetCollidingPairsToCheck(std::vector<SPolygonPair>& pairsToCheck) = 0;
+
+	// Polygons whose AABB overlaps box, as of the last Update
+	// Only reads the structure, can be called from several threads at once
+	virtual void QueryAABB(const AABB& box, std::vector<CPolygonPtr>& polygons) const = 0;
 };
 
-#endif
\ No newline at end of file
+inline bool	AABBOverlap(const AABB& a, const AABB& b)
+{
+	return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y;
+}
+
+#endif
@@ -10,6 +10,8 @@
 class CBroadPhaseBrut : public IBroadPhase
 {
 public:
+	virtual void Update() override{}
+
 	virtual void GetCollidingPairsToCheck(std::vector<SPolygonPair>& pairsToCheck) override
 	{
 		for (size_t i = 0; i < gVars->pWorld->GetPolygonCount(); ++i)
@@ -22,10 +24,24 @@ public:
 				if (pA->density == 0.0f && pB->density == 0.0f)
 					continue;
 
+				if (!ShouldCollide(pA->filter, pB->filter))
+					continue;
+
 				pairsToCheck.push_back(SPolygonPair(gVars->pWorld->GetPolygon(i), gVars->pWorld->GetPolygon(j)));
 			}
 		}
 	}
+
+	virtual void QueryAABB(const AABB& box, std::vector<CPolygonPtr>& polygons) const override
+	{
+		gVars->pWorld->ForEachPolygon([&](CPolygonPtr poly)
+		{
+			if (AABBOverlap(*poly->aabb, box))
+			{
+				polygons.push_back(poly);
+			}
+		});
+	}
 };
 
 #endif
\ No newline at end of file
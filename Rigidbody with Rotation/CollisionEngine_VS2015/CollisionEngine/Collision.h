@@ -1,6 +1,8 @@
 #ifndef _COLLISION_H_
 #define _COLLISION_H_
 
+#include <functional>
+
 #include "Polygon.h"
 
 struct SPolygonPair
@@ -11,6 +13,37 @@ struct SPolygonPair
 	CPolygonPtr	polyB;
 };
 
+// Narrow phase data of a pair kept from one frame to the next
+struct SNarrowPhaseCache
+{
+	const CPolygon*	axisOwner = nullptr; // polygon owning the last SAT separating edge, nullptr if the pair was colliding
+	size_t			axisEdge = 0;
+	Vec2			searchDirection; // last GJK search direction, zero if unknown
+};
+
+// Identify a pair of polygons whatever the order they are given
+struct SPairKey
+{
+	SPairKey(const CPolygon* _pA, const CPolygon* _pB)
+		: pA(_pA < _pB ? _pA : _pB), pB(_pA < _pB ? _pB : _pA){}
+
+	bool operator==(const SPairKey& rhs) const
+	{
+		return pA == rhs.pA && pB == rhs.pB;
+	}
+
+	const CPolygon* pA, *pB;
+};
+
+struct SPairKeyHash
+{
+	size_t operator()(const SPairKey& key) const
+	{
+		size_t hashA = std::hash<const CPolygon*>()(key.pA);
+		return hashA ^ (std::hash<const CPolygon*>()(key.pB) + 0x9e3779b9 + (hashA << 6) + (hashA >> 2));
+	}
+};
+
 struct SContactInfo
 {
 	SContactInfo() = default;
@@ -37,7 +70,11 @@ struct SContactInfo
 	Vec2	edgeNormalA;
 	Vec2	edgeNormalB;
 
-	size_t	index;
+	size_t	index; // feature id, stable from one frame to the next
+
+	// Accumulated impulses, carried over by the pair cache when the same feature id is found again
+	float	normalImpulse = 0.0f;
+	float	tangentImpulse = 0.0f;
 };
 
 struct SContact
@@ -0,0 +1,225 @@
+#include "ContactSolver.h"
+
+#include "GlobalVariables.h"
+#include "PhysicEngine.h"
+#include "ThreadPool.h"
+#include "World.h"
+
+static float	GetInverseMass(const CPolygon& body)
+{
+	return (body.density == 0.0f) ? 0.0f : 1.0f / body.GetMass();
+}
+
+static float	GetInverseInertia(const CPolygon& body)
+{
+	float inertia = (body.density == 0.0f) ? 0.0f : body.GetInertiaTensor();
+	return (inertia > 0.0f) ? 1.0f / inertia : 0.0f;
+}
+
+// Velocity of B relative to A at the contact
+static Vec2	GetRelativeVelocity(const CPolygon& bodyA, const CPolygon& bodyB, const Vec2& rA, const Vec2& rB)
+{
+	return bodyB.speed + rB.GetNormal() * bodyB.angularVelocity - bodyA.speed - rA.GetNormal() * bodyA.angularVelocity;
+}
+
+void	CContactSolver::Solve(const std::vector<SCachedPair*>& pairs, float deltaTime, float restitution)
+{
+	CFrameArena& arena = gVars->pPhysicEngine->GetFrameArena();
+
+	// Pairs of statics have nothing to solve
+	TFrameVector<SCachedPair*> contactPairs(arena);
+	for (SCachedPair* pair : pairs)
+	{
+		if (pair->colliding && pair->manifoldSize > 0 && (pair->polyA->density != 0.0f || pair->polyB->density != 0.0f))
+		{
+			contactPairs.push_back(pair);
+		}
+	}
+
+	// Greedy coloring, each constraint takes the first color free on both of its dynamic bodies
+	TFrameVector<uint8_t> colors(contactPairs.size(), 0, arena);
+	m_bodyColors.assign(gVars->pWorld->GetPolygonCount(), 0);
+	m_colorOffsets.assign(SOLVER_MAX_COLORS + 2, 0);
+	for (size_t i = 0; i < contactPairs.size(); ++i)
+	{
+		const CPolygon& bodyA = *contactPairs[i]->polyA;
+		const CPolygon& bodyB = *contactPairs[i]->polyB;
+		bool dynamicA = (bodyA.density != 0.0f);
+		bool dynamicB = (bodyB.density != 0.0f);
+
+		uint64_t used = (dynamicA ? m_bodyColors[bodyA.GetIndex()] : 0) | (dynamicB ? m_bodyColors[bodyB.GetIndex()] : 0);
+		size_t color = 0;
+		while (color < SOLVER_MAX_COLORS && (used & ((uint64_t)1 << color)))
+		{
+			++color;
+		}
+
+		if (color < SOLVER_MAX_COLORS)
+		{
+			uint64_t bit = (uint64_t)1 << color;
+			if (dynamicA)
+			{
+				m_bodyColors[bodyA.GetIndex()] |= bit;
+			}
+			if (dynamicB)
+			{
+				m_bodyColors[bodyB.GetIndex()] |= bit;
+			}
+		}
+
+		colors[i] = (uint8_t)color;
+		++m_colorOffsets[color + 1];
+	}
+
+	for (size_t color = 0; color <= SOLVER_MAX_COLORS; ++color)
+	{
+		m_colorOffsets[color + 1] += m_colorOffsets[color];
+	}
+
+	TFrameVector<size_t> nextConstraint(m_colorOffsets.begin(), m_colorOffsets.end() - 1, arena);
+	m_constraints.resize(contactPairs.size());
+	for (size_t i = 0; i < contactPairs.size(); ++i)
+	{
+		PrepareConstraint(m_constraints[nextConstraint[colors[i]]++], *contactPairs[i], deltaTime, restitution);
+	}
+
+	// Constraints of a color touch different dynamic bodies, the last color may not and stays on this thread
+	auto forEachColor = [&](auto function)
+	{
+		for (size_t color = 0; color <= SOLVER_MAX_COLORS; ++color)
+		{
+			size_t first = m_colorOffsets[color];
+			size_t count = m_colorOffsets[color + 1] - first;
+			auto solveRange = [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; ++i)
+				{
+					function(m_constraints[first + i]);
+				}
+			};
+
+			if (color < SOLVER_MAX_COLORS)
+			{
+				gVars->pThreadPool->ParallelFor(count, SOLVER_CHUNK_SIZE, solveRange);
+			}
+			else
+			{
+				solveRange(0, count);
+			}
+		}
+	};
+
+	forEachColor([&](SConstraint& constraint)
+	{
+		WarmStart(constraint);
+	});
+
+	for (size_t iteration = 0; iteration < SOLVER_ITERATIONS; ++iteration)
+	{
+		forEachColor([&](SConstraint& constraint)
+		{
+			SolveConstraint(constraint);
+		});
+	}
+}
+
+size_t	CContactSolver::GetConstraintCount() const
+{
+	return m_constraints.size();
+}
+
+size_t	CContactSolver::GetColorCount() const
+{
+	size_t colorCount = 0;
+	for (size_t color = 0; color + 1 < m_colorOffsets.size(); ++color)
+	{
+		colorCount += (m_colorOffsets[color + 1] > m_colorOffsets[color]) ? 1 : 0;
+	}
+	return colorCount;
+}
+
+void	CContactSolver::PrepareConstraint(SConstraint& constraint, SCachedPair& pair, float deltaTime, float restitution) const
+{
+	constraint.bodyA = pair.polyA.get();
+	constraint.bodyB = pair.polyB.get();
+	constraint.invMassA = GetInverseMass(*constraint.bodyA);
+	constraint.invMassB = GetInverseMass(*constraint.bodyB);
+	constraint.invInertiaA = GetInverseInertia(*constraint.bodyA);
+	constraint.invInertiaB = GetInverseInertia(*constraint.bodyB);
+	constraint.pointCount = pair.manifoldSize;
+
+	for (size_t i = 0; i < pair.manifoldSize; ++i)
+	{
+		SContactPoint& point = constraint.points[i];
+		point.info = &pair.manifold[i];
+		point.rA = point.info->point - constraint.bodyA->position;
+		point.rB = point.info->point - constraint.bodyB->position;
+
+		const Vec2& normal = point.info->normal;
+		Vec2 tangent = normal.GetNormal();
+		float rnA = point.rA ^ normal, rnB = point.rB ^ normal;
+		float rtA = point.rA ^ tangent, rtB = point.rB ^ tangent;
+		float invMassSum = constraint.invMassA + constraint.invMassB;
+		point.normalMass = 1.0f / (invMassSum + constraint.invInertiaA * rnA * rnA + constraint.invInertiaB * rnB * rnB);
+		point.tangentMass = 1.0f / (invMassSum + constraint.invInertiaA * rtA * rtA + constraint.invInertiaB * rtB * rtB);
+
+		// Push out of penetration, and bounce off fast impacts
+		point.velocityBias = SOLVER_BAUMGARTE / deltaTime * Max(point.info->penetration - SOLVER_SLOP, 0.0f);
+		float normalSpeed = GetRelativeVelocity(*constraint.bodyA, *constraint.bodyB, point.rA, point.rB) | normal;
+		if (normalSpeed < -SOLVER_BOUNCE_SPEED)
+		{
+			point.velocityBias = Max(point.velocityBias, -restitution * normalSpeed);
+		}
+	}
+}
+
+void	CContactSolver::WarmStart(const SConstraint& constraint) const
+{
+	for (size_t i = 0; i < constraint.pointCount; ++i)
+	{
+		const SContactPoint& point = constraint.points[i];
+		const Vec2& normal = point.info->normal;
+		ApplyImpulse(constraint, point, normal * point.info->normalImpulse + normal.GetNormal() * point.info->tangentImpulse);
+	}
+}
+
+void	CContactSolver::SolveConstraint(SConstraint& constraint) const
+{
+	const CPolygon& bodyA = *constraint.bodyA;
+	const CPolygon& bodyB = *constraint.bodyB;
+
+	for (size_t i = 0; i < constraint.pointCount; ++i)
+	{
+		SContactPoint& point = constraint.points[i];
+		SContactInfo& info = *point.info;
+		Vec2 tangent = info.normal.GetNormal();
+
+		// Friction, within the cone of the current normal impulse
+		float tangentSpeed = GetRelativeVelocity(bodyA, bodyB, point.rA, point.rB) | tangent;
+		float maxFriction = SOLVER_FRICTION * info.normalImpulse;
+		float tangentImpulse = Clamp(info.tangentImpulse - point.tangentMass * tangentSpeed, -maxFriction, maxFriction);
+		ApplyImpulse(constraint, point, tangent * (tangentImpulse - info.tangentImpulse));
+		info.tangentImpulse = tangentImpulse;
+
+		// Accumulated normal impulse only pushes
+		float normalSpeed = GetRelativeVelocity(bodyA, bodyB, point.rA, point.rB) | info.normal;
+		float normalImpulse = Max(info.normalImpulse + point.normalMass * (point.velocityBias - normalSpeed), 0.0f);
+		ApplyImpulse(constraint, point, info.normal * (normalImpulse - info.normalImpulse));
+		info.normalImpulse = normalImpulse;
+	}
+}
+
+void	CContactSolver::ApplyImpulse(const SConstraint& constraint, const SContactPoint& point, const Vec2& impulse) const
+{
+	// Static bodies are shared between colors, they must not even be written
+	if (constraint.invMassA > 0.0f)
+	{
+		constraint.bodyA->speed -= impulse * constraint.invMassA;
+		constraint.bodyA->angularVelocity -= constraint.invInertiaA * (point.rA ^ impulse);
+	}
+	if (constraint.invMassB > 0.0f)
+	{
+		constraint.bodyB->speed += impulse * constraint.invMassB;
+		constraint.bodyB->angularVelocity += constraint.invInertiaB * (point.rB ^ impulse);
+	}
+}
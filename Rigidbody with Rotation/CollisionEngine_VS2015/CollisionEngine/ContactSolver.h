@@ -0,0 +1,62 @@
+#ifndef _CONTACT_SOLVER_H_
+#define _CONTACT_SOLVER_H_
+
+#include <stdint.h>
+#include <vector>
+
+#include "PairCache.h"
+
+#define SOLVER_ITERATIONS		10
+// Penetration left unsolved, and fraction of the rest pushed out each step
+#define SOLVER_SLOP				0.01f
+#define SOLVER_BAUMGARTE		0.2f
+// Slower impacts do not bounce, so resting contacts stay still
+#define SOLVER_BOUNCE_SPEED		1.0f
+#define SOLVER_FRICTION			0.4f
+// At most 64 colors, constraints that would need more are solved on one thread after the others
+#define SOLVER_MAX_COLORS		64
+#define SOLVER_CHUNK_SIZE		64
+
+// Sequential impulses over the contacts of the colliding pairs, warm started from the impulses of the pair cache
+// Constraints are colored so that no two of a color share a dynamic body, each color is then solved in parallel
+// Static bodies (density 0) are never written, they do not constrain the coloring
+class CContactSolver
+{
+public:
+	// Accumulated impulses are written back to the pair manifolds for the next step
+	void	Solve(const std::vector<SCachedPair*>& pairs, float deltaTime, float restitution);
+
+	size_t	GetConstraintCount() const;
+	size_t	GetColorCount() const; // last solve, including the single thread one
+
+private:
+	struct SContactPoint
+	{
+		SContactInfo*	info; // in the pair manifold
+		Vec2			rA, rB;
+		float			normalMass;
+		float			tangentMass;
+		float			velocityBias;
+	};
+
+	struct SConstraint
+	{
+		CPolygon*		bodyA;
+		CPolygon*		bodyB;
+		float			invMassA, invMassB;
+		float			invInertiaA, invInertiaB;
+		SContactPoint	points[2];
+		size_t			pointCount;
+	};
+
+	void	PrepareConstraint(SConstraint& constraint, SCachedPair& pair, float deltaTime, float restitution) const;
+	void	WarmStart(const SConstraint& constraint) const;
+	void	SolveConstraint(SConstraint& constraint) const;
+	void	ApplyImpulse(const SConstraint& constraint, const SContactPoint& point, const Vec2& impulse) const;
+
+	std::vector<SConstraint>	m_constraints; // sorted by color
+	std::vector<size_t>			m_colorOffsets; // constraints of color c are [m_colorOffsets[c], m_colorOffsets[c + 1])
+	std::vector<uint64_t>		m_bodyColors; // colors used by each dynamic body, by world index
+};
+
+#endif
@@ -0,0 +1,73 @@
+#include "FrameArena.h"
+
+#include <malloc.h>
+#include <stdlib.h>
+
+static size_t	AlignSize(size_t size)
+{
+	return (size + FRAME_ARENA_ALIGNMENT - 1) & ~(size_t)(FRAME_ARENA_ALIGNMENT - 1);
+}
+
+CFrameArena::CFrameArena(size_t size)
+	: m_offset(0)
+{
+	m_capacity = AlignSize(size);
+	m_block = static_cast<char*>(_aligned_malloc(m_capacity, FRAME_ARENA_ALIGNMENT));
+	++m_heapAllocationCount;
+}
+
+CFrameArena::~CFrameArena()
+{
+	Reset();
+	_aligned_free(m_block);
+}
+
+void*	CFrameArena::Allocate(size_t size)
+{
+	size = AlignSize(size);
+	size_t offset = m_offset.fetch_add(size);
+	if (offset + size <= m_capacity)
+	{
+		return m_block + offset;
+	}
+
+	std::lock_guard<std::mutex> lock(m_overflowMutex);
+	void* overflow = _aligned_malloc(size, FRAME_ARENA_ALIGNMENT);
+	m_overflows.push_back(overflow);
+	++m_heapAllocationCount;
+	return overflow;
+}
+
+void	CFrameArena::Reset()
+{
+	size_t used = m_offset.exchange(0);
+	for (void* overflow : m_overflows)
+	{
+		_aligned_free(overflow);
+	}
+	m_overflows.clear();
+
+	// Next steps fit in the block, with some margin
+	if (used > m_capacity)
+	{
+		_aligned_free(m_block);
+		m_capacity = AlignSize(used + used / 2);
+		m_block = static_cast<char*>(_aligned_malloc(m_capacity, FRAME_ARENA_ALIGNMENT));
+		++m_heapAllocationCount;
+	}
+}
+
+size_t	CFrameArena::GetCapacity() const
+{
+	return m_capacity;
+}
+
+size_t	CFrameArena::GetUsedSize() const
+{
+	return m_offset;
+}
+
+size_t	CFrameArena::GetHeapAllocationCount() const
+{
+	return m_heapAllocationCount;
+}
@@ -0,0 +1,90 @@
+#ifndef _FRAME_ARENA_H_
+#define _FRAME_ARENA_H_
+
+#include <stddef.h>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <vector>
+
+// Initial size, the arena grows to the peak use of a step when it is exceeded
+#define FRAME_ARENA_DEFAULT_SIZE	(256 * 1024)
+// Every allocation is rounded up to this, so each one is aligned for any type
+#define FRAME_ARENA_ALIGNMENT		16
+
+// Bump allocator for the transient data of a physic step, everything is freed at once by Reset()
+// Allocations past the block go to the heap until the next Reset(), which grows the block to fit them
+// Allocate() can be called from several threads at once, Reset() only when nothing uses the arena
+class CFrameArena
+{
+public:
+	CFrameArena(size_t size = FRAME_ARENA_DEFAULT_SIZE);
+	~CFrameArena();
+
+	CFrameArena(const CFrameArena&) = delete;
+	CFrameArena& operator=(const CFrameArena&) = delete;
+
+	void*	Allocate(size_t size);
+	void	Reset();
+
+	size_t	GetCapacity() const;
+	size_t	GetUsedSize() const; // including overflow
+
+	// Heap allocations made by the arena since it was created
+	size_t	GetHeapAllocationCount() const;
+
+private:
+	char*				m_block = nullptr;
+	size_t				m_capacity = 0;
+	std::atomic<size_t>	m_offset;
+
+	std::mutex			m_overflowMutex;
+	std::vector<void*>	m_overflows;
+	size_t				m_heapAllocationCount = 0;
+};
+
+// Standard allocator over a frame arena, deallocate does nothing
+template<typename T>
+class TFrameAllocator
+{
+public:
+	typedef T	value_type;
+
+	TFrameAllocator(CFrameArena& arena) : m_arena(&arena){}
+
+	template<typename U>
+	TFrameAllocator(const TFrameAllocator<U>& other) : m_arena(other.GetArena()){}
+
+	T*		allocate(size_t count)
+	{
+		return static_cast<T*>(m_arena->Allocate(count * sizeof(T)));
+	}
+
+	void	deallocate(T*, size_t){}
+
+	CFrameArena*	GetArena() const
+	{
+		return m_arena;
+	}
+
+	template<typename U>
+	bool	operator==(const TFrameAllocator<U>& other) const
+	{
+		return m_arena == other.GetArena();
+	}
+
+	template<typename U>
+	bool	operator!=(const TFrameAllocator<U>& other) const
+	{
+		return m_arena != other.GetArena();
+	}
+
+private:
+	CFrameArena*	m_arena;
+};
+
+// Must not outlive the step it was made in
+template<typename T>
+using TFrameVector = std::vector<T, TFrameAllocator<T>>;
+
+#endif
@@ -0,0 +1,149 @@
+#include "FramePacer.h"
+
+#include <thread>
+#include <math.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <mmsystem.h>
+#endif
+
+#include "Maths.h"
+
+CFramePacer::CFramePacer()
+	: m_frameStart(Clock::now()), m_deadline(m_frameStart)
+{
+}
+
+CFramePacer::~CFramePacer()
+{
+	SetTimerResolution(false);
+}
+
+void	CFramePacer::SetTargetFrameTime(float frameTime)
+{
+	SetTimerResolution(frameTime > 0.0f);
+
+	m_targetFrameTime = frameTime;
+	m_frameStart = Clock::now();
+	m_deadline = m_frameStart + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(frameTime));
+
+	m_jitterSum = m_jitterMax = 0.0f;
+	m_statsFrames = 0;
+	m_averageJitter = m_maxJitter = 0.0f;
+}
+
+float	CFramePacer::GetTargetFrameTime() const
+{
+	return m_targetFrameTime;
+}
+
+void	CFramePacer::SetIdleJob(const std::function<bool(float)>& job)
+{
+	m_idleJob = job;
+}
+
+void	CFramePacer::WaitForNextFrame()
+{
+	if (m_targetFrameTime <= 0.0f)
+	{
+		return;
+	}
+
+	float remainingTime = GetRemainingTime();
+
+	bool hasIdleWork = (bool)m_idleJob;
+	while (hasIdleWork && remainingTime > m_sleepOvershoot + FRAME_PACER_SPIN_TIME)
+	{
+		hasIdleWork = m_idleJob(remainingTime - m_sleepOvershoot - FRAME_PACER_SPIN_TIME);
+		remainingTime = GetRemainingTime();
+	}
+
+	Sleep(remainingTime);
+
+	while (Clock::now() < m_deadline)
+	{
+		std::this_thread::yield();
+	}
+
+	Clock::time_point now = Clock::now();
+	UpdateStats(now);
+
+	// Next deadline from the previous one keeps the rate, unless this frame was already a whole frame late
+	Clock::duration targetDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(m_targetFrameTime));
+	m_deadline += targetDuration;
+	if (m_deadline < now)
+	{
+		m_deadline = now + targetDuration;
+	}
+	m_frameStart = now;
+}
+
+float	CFramePacer::GetAverageJitter() const
+{
+	return m_averageJitter;
+}
+
+float	CFramePacer::GetMaxJitter() const
+{
+	return m_maxJitter;
+}
+
+float	CFramePacer::GetRemainingTime() const
+{
+	return std::chrono::duration<float>(m_deadline - Clock::now()).count();
+}
+
+void	CFramePacer::Sleep(float remainingTime)
+{
+	// Short sleeps, their overshoot is measured so the last one ends before the deadline
+	while (remainingTime > m_sleepOvershoot + FRAME_PACER_SPIN_TIME)
+	{
+		float sleepTime = Min(remainingTime - m_sleepOvershoot - FRAME_PACER_SPIN_TIME, 0.001f);
+
+		Clock::time_point before = Clock::now();
+		std::this_thread::sleep_for(std::chrono::duration<float>(sleepTime));
+		float sleptTime = std::chrono::duration<float>(Clock::now() - before).count();
+
+		float overshoot = Min(Max(sleptTime - sleepTime, 0.0f), FRAME_PACER_MAX_OVERSHOOT);
+		m_sleepOvershoot += (overshoot - m_sleepOvershoot) * FRAME_PACER_OVERSHOOT_SMOOTHING;
+
+		remainingTime = GetRemainingTime();
+	}
+}
+
+void	CFramePacer::UpdateStats(Clock::time_point now)
+{
+	float frameTime = std::chrono::duration<float>(now - m_frameStart).count();
+	float jitter = fabsf(frameTime - m_targetFrameTime);
+
+	m_jitterSum += jitter;
+	m_jitterMax = Max(m_jitterMax, jitter);
+	if (++m_statsFrames == FRAME_PACER_STATS_FRAMES)
+	{
+		m_averageJitter = m_jitterSum / (float)m_statsFrames;
+		m_maxJitter = m_jitterMax;
+		m_jitterSum = m_jitterMax = 0.0f;
+		m_statsFrames = 0;
+	}
+}
+
+void	CFramePacer::SetTimerResolution(bool high)
+{
+	if (high == m_highTimerResolution)
+	{
+		return;
+	}
+
+#ifdef _WIN32
+	if (high)
+	{
+		timeBeginPeriod(1);
+	}
+	else
+	{
+		timeEndPeriod(1);
+	}
+#endif
+	m_highTimerResolution = high;
+}
@@ -0,0 +1,65 @@
+#ifndef _FRAME_PACER_H_
+#define _FRAME_PACER_H_
+
+#include <chrono>
+#include <functional>
+
+// Only the end of the wait spins, the rest sleeps
+#define FRAME_PACER_SPIN_TIME		0.0005f
+// Sleep overshoot estimate, smoothed both ways and capped so one late wake up cannot turn the wait into a spin
+#define FRAME_PACER_OVERSHOOT_SMOOTHING	0.1f
+#define FRAME_PACER_MAX_OVERSHOOT		0.002f
+// Jitter statistics are refreshed every this many frames
+#define FRAME_PACER_STATS_FRAMES	60
+
+// Waits for the end of each frame at a fixed target frame time
+// Sleeps for most of the remaining time so other threads get the core, then spins for the last FRAME_PACER_SPIN_TIME
+// On Windows the system timer is set to 1 ms while a target is set, sleeps would otherwise last a whole 15.6 ms tick
+class CFramePacer
+{
+public:
+	CFramePacer();
+	~CFramePacer();
+
+	CFramePacer(const CFramePacer&) = delete;
+	CFramePacer& operator=(const CFramePacer&) = delete;
+
+	// 0 : unlocked, WaitForNextFrame returns immediately
+	void	SetTargetFrameTime(float frameTime);
+	float	GetTargetFrameTime() const;
+
+	// Runs in place of the sleeps, called repeatedly with the time it may take in seconds until it returns false
+	// It must return within that time, the pacer then sleeps and spins what is left
+	void	SetIdleJob(const std::function<bool(float)>& job);
+
+	void	WaitForNextFrame();
+
+	// Deviation of the frame time from the target, in seconds, over the last FRAME_PACER_STATS_FRAMES frames
+	float	GetAverageJitter() const;
+	float	GetMaxJitter() const;
+
+private:
+	typedef std::chrono::steady_clock	Clock;
+
+	float	GetRemainingTime() const;
+	void	Sleep(float remainingTime);
+	void	UpdateStats(Clock::time_point now);
+	void	SetTimerResolution(bool high);
+
+	float					m_targetFrameTime = 0.0f;
+	Clock::time_point		m_frameStart;
+	Clock::time_point		m_deadline;
+	std::function<bool(float)>	m_idleJob;
+
+	// Average time a sleep takes more than asked, no sleep is started closer than that to the deadline
+	float	m_sleepOvershoot = 0.001f;
+	bool	m_highTimerResolution = false;
+
+	float	m_jitterSum = 0.0f;
+	float	m_jitterMax = 0.0f;
+	size_t	m_statsFrames = 0;
+	float	m_averageJitter = 0.0f;
+	float	m_maxJitter = 0.0f;
+};
+
+#endif
@@ -0,0 +1,103 @@
+#include "GLRenderBackend.h"
+
+#include "GlobalVariables.h"
+#include "RenderWindow.h"
+
+#include "drawtext.h"
+
+COpenGLRenderBackend::COpenGLRenderBackend()
+	: m_debugLineBuffer(GL_ARRAY_BUFFER)
+{
+}
+
+void	COpenGLRenderBackend::Init()
+{
+	// Init font
+	m_font = dtx_open_font("font.ttf", 24);
+	dtx_use_font(m_font, 24);
+}
+
+void	COpenGLRenderBackend::Reshape(int width, int height)
+{
+	glViewport(0, 0, width, height);
+}
+
+void	COpenGLRenderBackend::BeginFrame(float worldWidth, float worldHeight)
+{
+	glClearColor(0.05f, 0.05f, 0.05f, 0.05f);
+	glClear(GL_COLOR_BUFFER_BIT);
+
+	glMatrixMode(GL_PROJECTION);
+	glLoadIdentity();
+	glOrtho(-worldWidth * 0.5f, worldWidth * 0.5f, -worldHeight * 0.5f, worldHeight * 0.5f, 0.1f, 10.0f);
+
+	glMatrixMode(GL_MODELVIEW);
+	glTranslatef(0.0f, 0.0f, 0.0f); // move camera here
+}
+
+void	COpenGLRenderBackend::EndFrame()
+{
+}
+
+void	COpenGLRenderBackend::DrawPolygonBatch(const CPolygonBatch& batch, float r, float g, float b)
+{
+	m_batchRenderer.Draw(batch, r, g, b);
+}
+
+void	COpenGLRenderBackend::DrawPoints(const float* positionsX, const float* positionsY, size_t count, float radius, float r, float g, float b)
+{
+	m_particleRenderer.Draw(positionsX, positionsY, count, radius, r, g, b);
+}
+
+void	COpenGLRenderBackend::DrawLines(const SDebugVertex* vertices, size_t vertexCount)
+{
+	if (vertexCount == 0)
+	{
+		return;
+	}
+
+	size_t offset = m_debugLineBuffer.Upload(vertices, sizeof(SDebugVertex) * vertexCount);
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_COLOR_ARRAY);
+	glVertexPointer(2, GL_FLOAT, sizeof(SDebugVertex), (void*)offset);
+	glColorPointer(3, GL_FLOAT, sizeof(SDebugVertex), (void*)(offset + 2 * sizeof(float)));
+
+	glPushMatrix();
+	glTranslatef(0.0f, 0.0f, -1.0f);
+	glDrawArrays(GL_LINES, 0, (GLsizei)vertexCount);
+	glPopMatrix();
+
+	glDisableClientState(GL_COLOR_ARRAY);
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	m_debugLineBuffer.EndFrame();
+}
+
+void	COpenGLRenderBackend::DrawTexts(const std::vector<SRenderText>& texts)
+{
+	int width = gVars->pRenderWindow->GetWidth();
+	int height = gVars->pRenderWindow->Getheight();
+
+	//Light Gray text
+	glColor3f(0.7f, 0.7f, 0.7f);
+
+	// Set proj matrix to screen space
+	glMatrixMode(GL_PROJECTION);
+	glLoadIdentity();
+	glOrtho(0, width, 0, height, -1, 1);
+
+	// Reset model matrix
+	glMatrixMode(GL_MODELVIEW);
+	glLoadIdentity();
+
+	for (const SRenderText& text : texts)
+	{
+		glPushMatrix();
+
+		glTranslatef((float)text.x, (float)text.y, 0.0f);
+		dtx_string(text.text.c_str());
+
+		glPopMatrix();
+	}
+}
@@ -0,0 +1,34 @@
+#ifndef _GL_RENDER_BACKEND_H_
+#define _GL_RENDER_BACKEND_H_
+
+#include "RenderBackend.h"
+#include "BatchRenderer.h"
+#include "ParticleRenderer.h"
+#include "StreamBuffer.h"
+
+// Draw with the OpenGL context of the render window
+class COpenGLRenderBackend : public IRenderBackend
+{
+public:
+	COpenGLRenderBackend();
+
+	virtual void	Init() override;
+	virtual void	Reshape(int width, int height) override;
+
+	virtual void	BeginFrame(float worldWidth, float worldHeight) override;
+	virtual void	EndFrame() override;
+
+	virtual void	DrawPolygonBatch(const CPolygonBatch& batch, float r, float g, float b) override;
+	virtual void	DrawPoints(const float* positionsX, const float* positionsY, size_t count, float radius, float r, float g, float b) override;
+	virtual void	DrawLines(const SDebugVertex* vertices, size_t vertexCount) override;
+	virtual void	DrawTexts(const std::vector<SRenderText>& texts) override;
+
+private:
+	CBatchRenderer		m_batchRenderer;
+	CParticleRenderer	m_particleRenderer;
+	CStreamBuffer		m_debugLineBuffer;
+
+	struct dtx_font*	m_font = nullptr;
+};
+
+#endif
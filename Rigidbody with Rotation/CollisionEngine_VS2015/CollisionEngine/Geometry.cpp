@@ -0,0 +1,375 @@
+#include "Geometry.h"
+
+#include <algorithm>
+
+float	SignedArea2(const Vec2* points, size_t count)
+{
+	float area = 0.0f;
+	for (size_t i = 0; i < count; ++i)
+	{
+		area += points[i] ^ points[(i + 1) % count];
+	}
+	return area;
+}
+
+size_t	ComputeConvexHull(Vec2* points, size_t count, Vec2* hull)
+{
+	if (count < 3)
+	{
+		std::copy(points, points + count, hull);
+		return count;
+	}
+
+	std::sort(points, points + count, [](const Vec2& a, const Vec2& b)
+	{
+		return (a.y < b.y) || (a.y == b.y && a.x < b.x);
+	});
+
+	// Right chain going up then left chain going down, both keep left turns only
+	size_t size = 0;
+	for (size_t i = 0; i < count; ++i)
+	{
+		while (size >= 2 && ((hull[size - 1] - hull[size - 2]) ^ (points[i] - hull[size - 1])) <= 0.0f)
+		{
+			--size;
+		}
+		hull[size++] = points[i];
+	}
+
+	size_t lowerSize = size + 1;
+	for (size_t i = count - 1; i > 0; --i)
+	{
+		while (size >= lowerSize && ((hull[size - 1] - hull[size - 2]) ^ (points[i - 1] - hull[size - 1])) <= 0.0f)
+		{
+			--size;
+		}
+		hull[size++] = points[i - 1];
+	}
+
+	// Last point is the first one again
+	return size - 1;
+}
+
+void	ComputeConvexHull(std::vector<Vec2>& points)
+{
+	if (points.size() < 3)
+	{
+		return;
+	}
+
+	std::vector<Vec2> hull(2 * points.size());
+	hull.resize(ComputeConvexHull(points.data(), points.size(), hull.data()));
+	points.swap(hull);
+}
+
+// Scaled polygon walked counterclockwise from its lowest then leftmost point, read in place
+struct SMergeWalk
+{
+	SMergeWalk(const Vec2* points, size_t count, float scale)
+		: points(points), count(count), scale(scale), start(0), step(1)
+	{
+		// Scaling by -1 is a half turn, the winding stays the same
+		if (SignedArea2(points, count) < 0.0f)
+		{
+			step = count - 1;
+		}
+
+		for (size_t i = 1; i < count; ++i)
+		{
+			Vec2 point = points[i] * scale;
+			Vec2 lowest = points[start] * scale;
+			if (point.y < lowest.y || (point.y == lowest.y && point.x < lowest.x))
+			{
+				start = i;
+			}
+		}
+	}
+
+	Vec2	operator[](size_t index) const
+	{
+		return points[(start + (index % count) * step) % count] * scale;
+	}
+
+	const Vec2*	points;
+	size_t		count;
+	float		scale;
+	size_t		start;
+	size_t		step;
+};
+
+static size_t	MergeEdges(const Vec2* polyA, size_t countA, float scaleA, const Vec2* polyB, size_t countB, float scaleB, Vec2* result)
+{
+	if (countA == 0 || countB == 0)
+	{
+		return 0;
+	}
+
+	SMergeWalk a(polyA, countA, scaleA);
+	SMergeWalk b(polyB, countB, scaleB);
+
+	// Both start at their lowest point, then follow whichever next edge turns less
+	size_t size = 0;
+	size_t i = 0, j = 0;
+	while (i < countA || j < countB)
+	{
+		result[size++] = a[i] + b[j];
+
+		Vec2 edgeA = a[i + 1] - a[i];
+		Vec2 edgeB = b[j + 1] - b[j];
+		float cross = edgeA ^ edgeB;
+
+		bool advanceA = (i < countA) && (cross >= 0.0f || j == countB);
+		bool advanceB = (j < countB) && (cross <= 0.0f || i == countA);
+		i += advanceA ? 1 : 0;
+		j += advanceB ? 1 : 0;
+	}
+	return size;
+}
+
+size_t	MinkowskiSum(const Vec2* polyA, size_t countA, const Vec2* polyB, size_t countB, Vec2* result)
+{
+	return MergeEdges(polyA, countA, 1.0f, polyB, countB, 1.0f, result);
+}
+
+size_t	MinkowskiDifference(const Vec2* polyA, size_t countA, const Vec2* polyB, size_t countB, Vec2* result)
+{
+	return MergeEdges(polyA, countA, 1.0f, polyB, countB, -1.0f, result);
+}
+
+void	MinkowskiSum(const std::vector<Vec2>& polyA, const std::vector<Vec2>& polyB, std::vector<Vec2>& result)
+{
+	result.resize(polyA.size() + polyB.size());
+	result.resize(MinkowskiSum(polyA.data(), polyA.size(), polyB.data(), polyB.size(), result.data()));
+}
+
+void	MinkowskiDifference(const std::vector<Vec2>& polyA, const std::vector<Vec2>& polyB, std::vector<Vec2>& result)
+{
+	result.resize(polyA.size() + polyB.size());
+	result.resize(MinkowskiDifference(polyA.data(), polyA.size(), polyB.data(), polyB.size(), result.data()));
+}
+
+// Turns flatter than this fraction of the squared outline size are taken as collinear
+#define DECOMPOSITION_EPSILON	1e-6f
+
+static float	Turn(const Vec2& a, const Vec2& b, const Vec2& c)
+{
+	return (b - a) ^ (c - b);
+}
+
+static float	GetCollinearEpsilon(const std::vector<Vec2>& points)
+{
+	Vec2 min = points[0], max = points[0];
+	for (const Vec2& point : points)
+	{
+		min = minv(min, point);
+		max = maxv(max, point);
+	}
+	return DECOMPOSITION_EPSILON * (max - min).GetSqrLength();
+}
+
+bool	IsConvexPolygon(const std::vector<Vec2>& points)
+{
+	size_t count = points.size();
+	if (count < 4)
+	{
+		return true;
+	}
+
+	float epsilon = GetCollinearEpsilon(points);
+	float sign = (SignedArea2(points.data(), count) < 0.0f) ? -1.0f : 1.0f;
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (sign * Turn(points[(i + count - 1) % count], points[i], points[(i + 1) % count]) < -epsilon)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool	IsInsideTriangle(const Vec2& point, const Vec2& a, const Vec2& b, const Vec2& c)
+{
+	return ((b - a) ^ (point - a)) >= 0.0f && ((c - b) ^ (point - b)) >= 0.0f && ((a - c) ^ (point - c)) >= 0.0f;
+}
+
+// Ear clipping of a counterclockwise outline, collinear vertices are dropped on the way
+static bool	Triangulate(const std::vector<Vec2>& outline, float epsilon, std::vector<std::vector<size_t>>& triangles)
+{
+	std::vector<size_t> remaining(outline.size());
+	for (size_t i = 0; i < remaining.size(); ++i)
+	{
+		remaining[i] = i;
+	}
+
+	while (remaining.size() > 3)
+	{
+		size_t count = remaining.size();
+		size_t ear = count;
+		bool dropped = false;
+		for (size_t i = 0; i < count && ear == count && !dropped; ++i)
+		{
+			size_t prev = remaining[(i + count - 1) % count];
+			size_t next = remaining[(i + 1) % count];
+			const Vec2& a = outline[prev];
+			const Vec2& b = outline[remaining[i]];
+			const Vec2& c = outline[next];
+
+			float turn = Turn(a, b, c);
+			if (fabsf(turn) <= epsilon)
+			{
+				remaining.erase(remaining.begin() + i);
+				dropped = true;
+				continue;
+			}
+			if (turn < 0.0f)
+			{
+				continue;
+			}
+
+			// No other vertex may be in the ear, or the diagonal would cross the outline
+			bool isEar = true;
+			for (size_t j = 0; j < count && isEar; ++j)
+			{
+				size_t vertex = remaining[j];
+				const Vec2& point = outline[vertex];
+				if (vertex == prev || vertex == remaining[i] || vertex == next || point == a || point == b || point == c)
+				{
+					continue;
+				}
+				isEar = !IsInsideTriangle(point, a, b, c);
+			}
+
+			if (isEar)
+			{
+				ear = i;
+			}
+		}
+
+		if (dropped)
+		{
+			continue;
+		}
+		if (ear == count)
+		{
+			return false;
+		}
+
+		triangles.push_back({ remaining[(ear + count - 1) % count], remaining[ear], remaining[(ear + 1) % count] });
+		remaining.erase(remaining.begin() + ear);
+	}
+
+	if (remaining.size() == 3 && Turn(outline[remaining[0]], outline[remaining[1]], outline[remaining[2]]) > epsilon)
+	{
+		triangles.push_back(remaining);
+	}
+	return !triangles.empty();
+}
+
+static bool	IsConvexPiece(const std::vector<Vec2>& outline, const std::vector<size_t>& piece, float epsilon)
+{
+	size_t count = piece.size();
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (Turn(outline[piece[(i + count - 1) % count]], outline[piece[i]], outline[piece[(i + 1) % count]]) < -epsilon)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// Join the pieces on both sides of a diagonal if the result is convex
+static bool	TryMergePieces(const std::vector<Vec2>& outline, float epsilon, std::vector<size_t>& pieceA, const std::vector<size_t>& pieceB)
+{
+	size_t countA = pieceA.size();
+	size_t countB = pieceB.size();
+	for (size_t i = 0; i < countA; ++i)
+	{
+		size_t from = pieceA[i];
+		size_t to = pieceA[(i + 1) % countA];
+		for (size_t j = 0; j < countB; ++j)
+		{
+			// B has the same diagonal the other way
+			if (pieceB[j] != to || pieceB[(j + 1) % countB] != from)
+			{
+				continue;
+			}
+
+			// A from "to" around to "from", then B between them
+			std::vector<size_t> merged;
+			merged.reserve(countA + countB - 2);
+			for (size_t k = 0; k < countA; ++k)
+			{
+				merged.push_back(pieceA[(i + 1 + k) % countA]);
+			}
+			for (size_t k = 2; k < countB; ++k)
+			{
+				merged.push_back(pieceB[(j + k) % countB]);
+			}
+
+			if (!IsConvexPiece(outline, merged, epsilon))
+			{
+				return false;
+			}
+			pieceA.swap(merged);
+			return true;
+		}
+	}
+	return false;
+}
+
+bool	DecomposeConvex(const std::vector<Vec2>& points, std::vector<std::vector<Vec2>>& pieces)
+{
+	pieces.clear();
+	if (points.size() < 3)
+	{
+		return false;
+	}
+
+	std::vector<Vec2> outline(points);
+	if (SignedArea2(outline.data(), outline.size()) < 0.0f)
+	{
+		std::reverse(outline.begin(), outline.end());
+	}
+	float epsilon = GetCollinearEpsilon(outline);
+
+	std::vector<std::vector<size_t>> indexPieces;
+	if (!Triangulate(outline, epsilon, indexPieces))
+	{
+		return false;
+	}
+
+	// Each merge removes a diagonal, stop when none can go
+	bool merged = true;
+	while (merged)
+	{
+		merged = false;
+		for (size_t a = 0; a < indexPieces.size() && !merged; ++a)
+		{
+			for (size_t b = a + 1; b < indexPieces.size() && !merged; ++b)
+			{
+				if (TryMergePieces(outline, epsilon, indexPieces[a], indexPieces[b]))
+				{
+					indexPieces.erase(indexPieces.begin() + b);
+					merged = true;
+				}
+			}
+		}
+	}
+
+	for (const std::vector<size_t>& indexPiece : indexPieces)
+	{
+		size_t count = indexPiece.size();
+		std::vector<Vec2> piece;
+		for (size_t i = 0; i < count; ++i)
+		{
+			const Vec2& point = outline[indexPiece[i]];
+			if (fabsf(Turn(outline[indexPiece[(i + count - 1) % count]], point, outline[indexPiece[(i + 1) % count]])) > epsilon)
+			{
+				piece.push_back(point);
+			}
+		}
+		pieces.push_back(piece);
+	}
+	return true;
+}
@@ -0,0 +1,35 @@
+#ifndef _GEOMETRY_H_
+#define _GEOMETRY_H_
+
+#include <vector>
+
+#include "Maths.h"
+
+// Twice the signed area, positive when points are counterclockwise
+float	SignedArea2(const Vec2* points, size_t count);
+
+// Andrew's monotone chain, O(n log n)
+// Replaces points by their convex hull, counterclockwise from the lowest then leftmost point, without collinear points
+void	ComputeConvexHull(std::vector<Vec2>& points);
+// Same without allocating : points are sorted in place, hull must hold 2 * count points, returns the hull size
+size_t	ComputeConvexHull(Vec2* points, size_t count, Vec2* hull);
+
+// Convex polygons in any winding, result is counterclockwise
+// Edges of both polygons are merged by angle, O(n + m)
+void	MinkowskiSum(const std::vector<Vec2>& polyA, const std::vector<Vec2>& polyB, std::vector<Vec2>& result);
+// A + (-B)
+void	MinkowskiDifference(const std::vector<Vec2>& polyA, const std::vector<Vec2>& polyB, std::vector<Vec2>& result);
+
+// Same without allocating, result must hold countA + countB points, returns the result size
+size_t	MinkowskiSum(const Vec2* polyA, size_t countA, const Vec2* polyB, size_t countB, Vec2* result);
+size_t	MinkowskiDifference(const Vec2* polyA, size_t countA, const Vec2* polyB, size_t countB, Vec2* result);
+
+// Every turn goes the same way, collinear points allowed
+bool	IsConvexPolygon(const std::vector<Vec2>& points);
+
+// Hertel-Mehlhorn : ear clipping triangulation, then diagonals are removed while both sides stay convex
+// At most 4 times the optimal number of pieces, pieces are counterclockwise without collinear points
+// False if the outline is self intersecting
+bool	DecomposeConvex(const std::vector<Vec2>& points, std::vector<std::vector<Vec2>>& pieces);
+
+#endif
@@ -8,6 +8,8 @@ struct SGlobalVariables
 	class CWorld*			pWorld;
 	class CSceneManager*	pSceneManager;
 	class CPhysicEngine*	pPhysicEngine;
+	class CThreadPool*		pThreadPool;
+	class CPhysicThread*	pPhysicThread;
 
 	bool					bDebug;
 };
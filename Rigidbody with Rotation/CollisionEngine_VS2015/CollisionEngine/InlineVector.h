@@ -0,0 +1,100 @@
+#ifndef _INLINE_VECTOR_H_
+#define _INLINE_VECTOR_H_
+
+#include <stddef.h>
+#include <algorithm>
+#include <vector>
+
+// Vector storing up to TCapacity elements inside itself, more spill to the heap
+// Elements are default constructed in the inline buffer, meant for small POD types like Vec2
+template<typename T, size_t TCapacity>
+class TInlineVector
+{
+public:
+	typedef T			value_type;
+	typedef T*			iterator;
+	typedef const T*	const_iterator;
+
+	TInlineVector() = default;
+
+	template<typename TIterator>
+	TInlineVector(TIterator first, TIterator last)
+	{
+		assign(first, last);
+	}
+
+	size_t		size() const { return m_size; }
+	bool		empty() const { return m_size == 0; }
+	static size_t	inline_capacity() { return TCapacity; }
+	bool		is_inline() const { return m_size <= TCapacity; }
+
+	T*			data() { return is_inline() ? m_inline : m_spill.data(); }
+	const T*	data() const { return is_inline() ? m_inline : m_spill.data(); }
+
+	iterator		begin() { return data(); }
+	iterator		end() { return data() + m_size; }
+	const_iterator	begin() const { return data(); }
+	const_iterator	end() const { return data() + m_size; }
+
+	T&			operator[](size_t index) { return data()[index]; }
+	const T&	operator[](size_t index) const { return data()[index]; }
+	T&			back() { return data()[m_size - 1]; }
+	const T&	back() const { return data()[m_size - 1]; }
+
+	void	clear()
+	{
+		m_spill.clear();
+		m_size = 0;
+	}
+
+	void	resize(size_t size)
+	{
+		if (size > TCapacity)
+		{
+			// Inline elements move to the heap on the way out
+			if (is_inline())
+			{
+				m_spill.assign(m_inline, m_inline + m_size);
+			}
+			m_spill.resize(size);
+		}
+		else if (!is_inline())
+		{
+			std::copy(m_spill.begin(), m_spill.begin() + size, m_inline);
+			m_spill.clear();
+		}
+		else
+		{
+			std::fill(m_inline + std::min(m_size, size), m_inline + size, T());
+		}
+		m_size = size;
+	}
+
+	void	push_back(const T& value)
+	{
+		if (m_size < TCapacity)
+		{
+			m_inline[m_size++] = value;
+			return;
+		}
+
+		T copy = value; // value may be one of ours
+		resize(m_size + 1);
+		back() = copy;
+	}
+
+	template<typename TIterator>
+	void	assign(TIterator first, TIterator last)
+	{
+		clear();
+		resize((size_t)std::distance(first, last));
+		std::copy(first, last, begin());
+	}
+
+private:
+	T				m_inline[TCapacity];
+	std::vector<T>	m_spill; // only used past TCapacity
+	size_t			m_size = 0;
+};
+
+#endif
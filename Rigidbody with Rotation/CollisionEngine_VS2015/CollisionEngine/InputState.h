@@ -0,0 +1,26 @@
+#ifndef _INPUT_STATE_H_
+#define _INPUT_STATE_H_
+
+#include "Maths.h"
+
+#define INPUT_MOUSE_BUTTON_COUNT	3
+
+// Mouse and window size sampled by the main thread each frame, then handed to the physic tick (see CPhysicThread::SetInput)
+// Behaviors run on the physic thread, they read this instead of the render window or the renderer
+struct SInputState
+{
+	Vec2	mousePos; // world units
+	bool	mouseButtons[INPUT_MOUSE_BUTTON_COUNT] = {}; // left, middle, right
+
+	float	worldWidth = 0.0f;
+	float	worldHeight = 0.0f;
+	int		screenWidth = 0;
+	int		screenHeight = 0;
+
+	Vec2	WorldToScreenPos(const Vec2& pos) const
+	{
+		return pos * ((float)screenHeight / worldHeight) + Vec2((float)screenWidth, (float)screenHeight) * 0.5f;
+	}
+};
+
+#endif
@@ -172,18 +172,18 @@ void AABB::RenderBoundingBox()
 {
 	if (bIsColliding == true)
 	{
-		gVars->pRenderer->DrawLine(min, Vec2(max.x, min.y), 0.5f, 0.9f, 1);
-		gVars->pRenderer->DrawLine(Vec2(max.x, min.y), max, 0.5f, 0.9f, 1);
-		gVars->pRenderer->DrawLine(max, Vec2(min.x, max.y), 0.5f, 0.9f, 1);
-		gVars->pRenderer->DrawLine(Vec2(min.x, max.y), min, 0.5f, 0.9f, 1);
+		gVars->pRenderer->DrawLine(min, Vec2(max.x, min.y), 0.5f, 0.9f, 1, EDebugCategory::AABB);
+		gVars->pRenderer->DrawLine(Vec2(max.x, min.y), max, 0.5f, 0.9f, 1, EDebugCategory::AABB);
+		gVars->pRenderer->DrawLine(max, Vec2(min.x, max.y), 0.5f, 0.9f, 1, EDebugCategory::AABB);
+		gVars->pRenderer->DrawLine(Vec2(min.x, max.y), min, 0.5f, 0.9f, 1, EDebugCategory::AABB);
 	}
 	
 	else
 	{
-		gVars->pRenderer->DrawLine(min, Vec2(max.x, min.y), 0.3f, 0, 1);
-		gVars->pRenderer->DrawLine(Vec2(max.x, min.y), max, 0.3f, 0, 1);
-		gVars->pRenderer->DrawLine(max, Vec2(min.x, max.y), 0.3f, 0, 1);
-		gVars->pRenderer->DrawLine(Vec2(min.x, max.y), min, 0.3f, 0, 1);
+		gVars->pRenderer->DrawLine(min, Vec2(max.x, min.y), 0.3f, 0, 1, EDebugCategory::AABB);
+		gVars->pRenderer->DrawLine(Vec2(max.x, min.y), max, 0.3f, 0, 1, EDebugCategory::AABB);
+		gVars->pRenderer->DrawLine(max, Vec2(min.x, max.y), 0.3f, 0, 1, EDebugCategory::AABB);
+		gVars->pRenderer->DrawLine(Vec2(min.x, max.y), min, 0.3f, 0, 1, EDebugCategory::AABB);
 	}
 }
 
@@ -191,9 +191,9 @@ void Simplex::Draw()
 {
 	if (count == 3)
 	{
-		gVars->pRenderer->DrawLine(vertexArray[0], vertexArray[1], 0.4f, 0.1f, 0.7f);
-		gVars->pRenderer->DrawLine(vertexArray[1], vertexArray[2], 0.4f, 0.1f, 0.7f);
-		gVars->pRenderer->DrawLine(vertexArray[2], vertexArray[0], 0.4f, 0.1f, 0.7f);
+		gVars->pRenderer->DrawLine(vertexArray[0], vertexArray[1], 0.4f, 0.1f, 0.7f, EDebugCategory::Simplex);
+		gVars->pRenderer->DrawLine(vertexArray[1], vertexArray[2], 0.4f, 0.1f, 0.7f, EDebugCategory::Simplex);
+		gVars->pRenderer->DrawLine(vertexArray[2], vertexArray[0], 0.4f, 0.1f, 0.7f, EDebugCategory::Simplex);
 	}
 }
 
@@ -257,9 +257,9 @@ Vec2 Simplex::ClosestPoint(Vec2& firstPnt, Vec2& secondPnt, Vec2& thirdPnt, Vec2
 	// Inside the Triangle
 	if (uABC > 0.f && vABC > 0.f && wABC > 0.f)
 	{
-		gVars->pRenderer->DrawLine(firstPnt, secondPnt, 0.5f, 0.8f, 0.5f);
-		gVars->pRenderer->DrawLine(secondPnt, thirdPnt, 0.5f, 0.8f, 0.5f);
-		gVars->pRenderer->DrawLine(thirdPnt, firstPnt, 0.5f, 0.8f, 0.5f);
+		gVars->pRenderer->DrawLine(firstPnt, secondPnt, 0.5f, 0.8f, 0.5f, EDebugCategory::Simplex);
+		gVars->pRenderer->DrawLine(secondPnt, thirdPnt, 0.5f, 0.8f, 0.5f, EDebugCategory::Simplex);
+		gVars->pRenderer->DrawLine(thirdPnt, firstPnt, 0.5f, 0.8f, 0.5f, EDebugCategory::Simplex);
 
 		return p = externalPnt;
 	}
@@ -315,7 +315,7 @@ struct AABB
 		max = maxv(max, point);
 	}
 
-	bool Intersect(const AABB& aabb)
+	bool Intersect(const AABB& aabb) const
 	{
 		bool separateAxis = (min.x > aabb.max.x) || (min.y > aabb.max.y) || (aabb.min.x > max.x) || (aabb.min.y > max.y);
 		return !separateAxis;
@@ -0,0 +1,721 @@
+#include "NarrowPhase.h"
+
+#include <emmintrin.h>
+
+typedef bool(*TCollisionKernel)(const CPolygon&, const CPolygon&, SCollision&, SNarrowPhaseCache*);
+
+// Indexed by [shape type of A][shape type of B]
+static const TCollisionKernel gCollisionMatrix[(int)EShapeType::Count][(int)EShapeType::Count] =
+{
+	{ CollidePolygons,		CollidePolygonCircle,	CollideWithCompound },
+	{ CollideCirclePolygon,	CollideCircles,			CollideWithCompound },
+	{ CollideCompound,		CollideCompound,		CollideCompound },
+};
+
+static void SetSingleContact(SCollision& collision, const Vec2& point, const Vec2& normal, float penetration, size_t index)
+{
+	collision.point = point;
+	collision.normal = normal;
+	collision.distance = penetration;
+
+	collision.manifoldSize = 1;
+	collision.manifold[0] = SContactInfo(collision.polyA.get(), collision.polyB.get(), point, normal, penetration, index);
+}
+
+// Contact between a polygon and a circle, normal goes from the polygon to the circle
+static bool PolygonCircleContact(const CPolygon& poly, const CPolygon& circle, Vec2& point, Vec2& normal, float& penetration, size_t& index)
+{
+	const TShapeArray<Line>& lines = poly.GetShape()->GetLines();
+	float radius = circle.GetShape()->GetRadius();
+
+	// Work in polygon local space
+	Vec2 center = poly.InverseTransformPoint(circle.position);
+
+	float maxSeparation = -FLT_MAX;
+	size_t edgeIndex = 0;
+	for (size_t i = 0; i < lines.size(); ++i)
+	{
+		float separation = lines[i].GetPointDist(center);
+		if (separation > radius)
+		{
+			return false;
+		}
+
+		if (separation > maxSeparation)
+		{
+			maxSeparation = separation;
+			edgeIndex = i;
+		}
+	}
+
+	const Line& edge = lines[edgeIndex];
+	Vec2 localNormal = edge.GetNormal();
+	Vec2 localPoint;
+
+	// Index is 2 * edge for faces, 2 * vertex + 1 for vertices
+	Vec2 vertexA, vertexB;
+	edge.GetPoints(vertexA, vertexB); // points[edge + 1], points[edge]
+
+	if (maxSeparation <= 0.0f)
+	{
+		// Center inside the polygon
+		localPoint = center - localNormal * maxSeparation;
+		penetration = radius - maxSeparation;
+		index = edgeIndex * 2;
+	}
+	else if (((center - vertexA) | (vertexB - vertexA)) <= 0.0f)
+	{
+		float sqrDist = (center - vertexA).GetSqrLength();
+		if (sqrDist > radius * radius)
+		{
+			return false;
+		}
+
+		float dist = sqrtf(sqrDist);
+		localNormal = (center - vertexA) / dist;
+		localPoint = vertexA;
+		penetration = radius - dist;
+		index = ((edgeIndex + 1) % lines.size()) * 2 + 1;
+	}
+	else if (((center - vertexB) | (vertexA - vertexB)) <= 0.0f)
+	{
+		float sqrDist = (center - vertexB).GetSqrLength();
+		if (sqrDist > radius * radius)
+		{
+			return false;
+		}
+
+		float dist = sqrtf(sqrDist);
+		localNormal = (center - vertexB) / dist;
+		localPoint = vertexB;
+		penetration = radius - dist;
+		index = edgeIndex * 2 + 1;
+	}
+	else
+	{
+		localPoint = center - localNormal * maxSeparation;
+		penetration = radius - maxSeparation;
+		index = edgeIndex * 2;
+	}
+
+	point = poly.TransformPoint(localPoint);
+	normal = poly.rotation * localNormal;
+	return true;
+}
+
+bool	CollideCircles(const CPolygon& circleA, const CPolygon& circleB, SCollision& collision, SNarrowPhaseCache* cache)
+{
+	float radiusA = circleA.GetShape()->GetRadius();
+	float radiusB = circleB.GetShape()->GetRadius();
+	float radii = radiusA + radiusB;
+
+	Vec2 diff = circleB.position - circleA.position;
+	float sqrDist = diff.GetSqrLength();
+	if (sqrDist > radii * radii)
+	{
+		return false;
+	}
+
+	float dist = sqrtf(sqrDist);
+	Vec2 normal = (dist > 0.0f) ? diff / dist : Vec2(0.0f, 1.0f);
+	float penetration = radii - dist;
+
+	SetSingleContact(collision, circleA.position + normal * (radiusA - penetration * 0.5f), normal, penetration, 0);
+	return true;
+}
+
+bool	CollidePolygonCircle(const CPolygon& polyA, const CPolygon& circleB, SCollision& collision, SNarrowPhaseCache* cache)
+{
+	Vec2 point, normal;
+	float penetration;
+	size_t index;
+	if (!PolygonCircleContact(polyA, circleB, point, normal, penetration, index))
+	{
+		return false;
+	}
+
+	SetSingleContact(collision, point, normal, penetration, index);
+	return true;
+}
+
+bool	CollideCirclePolygon(const CPolygon& circleA, const CPolygon& polyB, SCollision& collision, SNarrowPhaseCache* cache)
+{
+	Vec2 point, normal;
+	float penetration;
+	size_t index;
+	if (!PolygonCircleContact(polyB, circleA, point, normal, penetration, index))
+	{
+		return false;
+	}
+
+	SetSingleContact(collision, point, normal * -1.0f, penetration, index);
+	return true;
+}
+
+// Index of the point furthest along direction
+static size_t GetSupportIndex(const TShapeArray<Vec2>& points, const Vec2& direction)
+{
+	size_t support = 0;
+	for (size_t i = 1; i < points.size(); ++i)
+	{
+		if ((points[i] | direction) > (points[support] | direction))
+		{
+			support = i;
+		}
+	}
+	return support;
+}
+
+// Largest cosine between direction and the outward normal of a face of the counterclockwise polygon
+static float GetFaceAlignment(const TShapeArray<Vec2>& points, const Vec2& direction)
+{
+	float alignment = -FLT_MAX;
+	for (size_t i = 0; i < points.size(); ++i)
+	{
+		Vec2 edge = points[(i + 1) % points.size()] - points[i];
+		if (edge.GetSqrLength() > 0.0f)
+		{
+			alignment = Max(alignment, (edge.GetNormal().Normalized() * -1.0f) | direction);
+		}
+	}
+	return alignment;
+}
+
+bool	CollidePolygons(const CPolygon& polyA, const CPolygon& polyB, SCollision& collision, SNarrowPhaseCache* cache)
+{
+	if (polyA.GetPoints().size() <= SAT_MAX_VERTICES && polyB.GetPoints().size() <= SAT_MAX_VERTICES)
+	{
+		return CollidePolygonsSAT(polyA, polyB, collision, cache);
+	}
+
+	if (!polyA.CheckCollision(polyB, collision, cache ? &cache->searchDirection : nullptr))
+	{
+		return false;
+	}
+
+	// Single contact, as SAT would : the polygon with a face most aligned with the normal is the reference,
+	// the contact is the deepest vertex of the other one. Feature ids of B are offset past those of A
+	const TShapeArray<Vec2>& pointsA = polyA.GetWorldPoints();
+	const TShapeArray<Vec2>& pointsB = polyB.GetWorldPoints();
+	Vec2 point;
+	size_t index;
+	if (GetFaceAlignment(pointsA, collision.normal) >= GetFaceAlignment(pointsB, collision.normal * -1.0f))
+	{
+		index = GetSupportIndex(pointsB, collision.normal * -1.0f);
+		point = pointsB[index];
+		index += pointsA.size();
+	}
+	else
+	{
+		index = GetSupportIndex(pointsA, collision.normal);
+		point = pointsA[index];
+	}
+
+	SetSingleContact(collision, point, collision.normal, collision.distance, index);
+	return true;
+}
+
+// Bounds of poly in the local space of compound, to query its child tree
+static AABB GetLocalBounds(const CPolygon& compound, const CPolygon& poly)
+{
+	AABB bounds;
+	if (poly.IsCircle())
+	{
+		Vec2 extent(poly.GetShape()->GetRadius(), poly.GetShape()->GetRadius());
+		Vec2 center = compound.InverseTransformPoint(poly.position);
+		bounds.min = center - extent;
+		bounds.max = center + extent;
+		return bounds;
+	}
+
+	const TShapeArray<Vec2>& worldPoints = poly.GetWorldPoints();
+	bounds.Center(compound.InverseTransformPoint(worldPoints[0]));
+	for (const Vec2& point : worldPoints)
+	{
+		bounds.Extend(compound.InverseTransformPoint(point));
+	}
+	return bounds;
+}
+
+// Keep the deepest contacts of all children, feature ids are salted with the child index to stay unique
+static void MergeChildContacts(SCollision& collision, const SCollision& childCollision, size_t salt, bool first)
+{
+	if (first || childCollision.distance > collision.distance)
+	{
+		collision.point = childCollision.point;
+		collision.normal = childCollision.normal;
+		collision.distance = childCollision.distance;
+	}
+
+	for (size_t i = 0; i < childCollision.manifoldSize; ++i)
+	{
+		SContactInfo contact = childCollision.manifold[i];
+		contact.index ^= salt;
+
+		if (collision.manifoldSize < 2)
+		{
+			collision.manifold[collision.manifoldSize++] = contact;
+			continue;
+		}
+
+		size_t shallowest = (collision.manifold[0].penetration < collision.manifold[1].penetration) ? 0 : 1;
+		if (contact.penetration > collision.manifold[shallowest].penetration)
+		{
+			collision.manifold[shallowest] = contact;
+		}
+	}
+}
+
+static bool CollideChildren(const CPolygon& compound, const CPolygon& other, bool compoundIsA, SCollision& collision)
+{
+	collision.manifoldSize = 0;
+	collision.distance = 0.0f;
+	bool colliding = false;
+
+	// Child pairs have no cache of their own, the pair one only fits a single axis
+	compound.GetShape()->ForEachOverlappingChild(GetLocalBounds(compound, other), [&](size_t childIndex)
+	{
+		const CPolygon& child = compound.GetChild(childIndex);
+
+		SCollision childCollision;
+		childCollision.polyA = collision.polyA;
+		childCollision.polyB = collision.polyB;
+		if (compoundIsA ? Collide(child, other, childCollision) : Collide(other, child, childCollision))
+		{
+			size_t salt = (childIndex + 1) * (compoundIsA ? 0x9e3779b9u : 0x85ebca6bu);
+			MergeChildContacts(collision, childCollision, salt, !colliding);
+			colliding = true;
+		}
+	});
+
+	// Contact point of the pair is the center of the kept contacts
+	if (collision.manifoldSize > 0)
+	{
+		collision.point = Vec2();
+		for (size_t i = 0; i < collision.manifoldSize; ++i)
+		{
+			collision.point += collision.manifold[i].point;
+		}
+		collision.point /= (float)collision.manifoldSize;
+	}
+	return colliding;
+}
+
+bool	CollideCompound(const CPolygon& compoundA, const CPolygon& polyB, SCollision& collision, SNarrowPhaseCache* cache)
+{
+	return CollideChildren(compoundA, polyB, true, collision);
+}
+
+bool	CollideWithCompound(const CPolygon& polyA, const CPolygon& compoundB, SCollision& collision, SNarrowPhaseCache* cache)
+{
+	return CollideChildren(compoundB, polyA, false, collision);
+}
+
+// World space vertices and edge normals, TCount is the vertex count or 0 when only known at runtime
+// With a fixed count every loop over the polygon has a constant trip count and is unrolled
+template<size_t TCount>
+struct TWorldPolygon
+{
+	static const size_t count = TCount;
+
+	TWorldPolygon(const CPolygon& poly)
+	{
+		const TShapeArray<Vec2>& localPoints = poly.GetPoints();
+		const TShapeArray<Vec2>& localNormals = poly.GetShape()->GetNormals();
+		for (size_t i = 0; i < TCount; ++i)
+		{
+			points[i] = poly.TransformPoint(localPoints[i]);
+			normals[i] = poly.rotation * localNormals[i];
+		}
+	}
+
+	// Edge i goes from points[i] to points[i + 1], normals[i] is its outward normal
+	Vec2	points[TCount];
+	Vec2	normals[TCount];
+};
+
+template<>
+struct TWorldPolygon<0>
+{
+	TWorldPolygon(const CPolygon& poly)
+		: count(poly.GetPoints().size())
+	{
+		const TShapeArray<Vec2>& localPoints = poly.GetPoints();
+		const TShapeArray<Vec2>& localNormals = poly.GetShape()->GetNormals();
+		for (size_t i = 0; i < count; ++i)
+		{
+			points[i] = poly.TransformPoint(localPoints[i]);
+			normals[i] = poly.rotation * localNormals[i];
+		}
+	}
+
+	Vec2	points[SAT_MAX_VERTICES];
+	Vec2	normals[SAT_MAX_VERTICES];
+	size_t	count;
+};
+
+template<typename TPoly, typename TOtherPoly>
+static float EdgeSeparation(const TPoly& poly, size_t edge, const TOtherPoly& otherPoly)
+{
+	float minDist = FLT_MAX;
+	for (size_t i = 0; i < otherPoly.count; ++i)
+	{
+		minDist = Min(minDist, (otherPoly.points[i] - poly.points[edge]) | poly.normals[edge]);
+	}
+	return minDist;
+}
+
+template<typename TPoly, typename TOtherPoly>
+static float FindMaxSeparation(const TPoly& poly, const TOtherPoly& otherPoly, size_t& edge)
+{
+	float maxSeparation = -FLT_MAX;
+	for (size_t i = 0; i < poly.count; ++i)
+	{
+		float separation = EdgeSeparation(poly, i, otherPoly);
+		if (separation > maxSeparation)
+		{
+			maxSeparation = separation;
+			edge = i;
+		}
+
+		if (separation > 0.0f)
+		{
+			break;
+		}
+	}
+	return maxSeparation;
+}
+
+// Keep the part of the segment where (point | normal) <= offset
+static size_t ClipSegment(const Vec2 segment[2], const size_t ids[2], const Vec2& normal, float offset, Vec2 clipped[2], size_t clippedIds[2])
+{
+	size_t count = 0;
+	float dist0 = (segment[0] | normal) - offset;
+	float dist1 = (segment[1] | normal) - offset;
+
+	if (dist0 <= 0.0f)
+	{
+		clippedIds[count] = ids[0];
+		clipped[count++] = segment[0];
+	}
+	if (dist1 <= 0.0f)
+	{
+		clippedIds[count] = ids[1];
+		clipped[count++] = segment[1];
+	}
+
+	if (dist0 * dist1 < 0.0f)
+	{
+		clippedIds[count] = Select(dist0 > 0.0f, ids[0], ids[1]);
+		clipped[count++] = segment[0] + (segment[1] - segment[0]) * (dist0 / (dist0 - dist1));
+	}
+	return count;
+}
+
+// Clip the incident edge of inc against the reference edge of ref
+template<typename TRef, typename TInc>
+static bool BuildManifold(const TRef& ref, const TInc& inc, size_t refEdge, bool flip, SCollision& collision)
+{
+	Vec2 refNormal = ref.normals[refEdge];
+
+	// Incident edge is the most anti-parallel to the reference normal
+	size_t incEdge = 0;
+	float minDot = FLT_MAX;
+	for (size_t i = 0; i < inc.count; ++i)
+	{
+		float dot = inc.normals[i] | refNormal;
+		if (dot < minDot)
+		{
+			minDot = dot;
+			incEdge = i;
+		}
+	}
+
+	Vec2 incident[2] = { inc.points[incEdge], inc.points[(incEdge + 1) % inc.count] };
+	size_t incidentIds[2] = { incEdge, (incEdge + 1) % inc.count };
+
+	const Vec2& refStart = ref.points[refEdge];
+	const Vec2& refEnd = ref.points[(refEdge + 1) % ref.count];
+	Vec2 tangent = (refEnd - refStart).Normalized();
+
+	// Clip incident edge against reference edge side planes
+	Vec2 clipped1[2], clipped2[2];
+	size_t clippedIds1[2], clippedIds2[2];
+	if (ClipSegment(incident, incidentIds, tangent * -1.0f, -(tangent | refStart), clipped1, clippedIds1) < 2)
+	{
+		return false;
+	}
+	if (ClipSegment(clipped1, clippedIds1, tangent, tangent | refEnd, clipped2, clippedIds2) < 2)
+	{
+		return false;
+	}
+
+	Vec2 normal = flip ? refNormal * -1.0f : refNormal;
+
+	collision.manifoldSize = 0;
+	collision.distance = 0.0f;
+	collision.point = Vec2();
+	for (size_t i = 0; i < 2; ++i)
+	{
+		float separation = (clipped2[i] - refStart) | refNormal;
+		if (separation > 0.0f)
+		{
+			continue;
+		}
+
+		// Feature id : which polygon is the reference, reference edge and incident vertex
+		size_t index = ((size_t)flip << 16) | (refEdge << 8) | clippedIds2[i];
+		collision.manifold[collision.manifoldSize++] = SContactInfo(collision.polyA.get(), collision.polyB.get(), clipped2[i], normal, -separation, index);
+
+		collision.point += clipped2[i];
+		collision.distance = Max(collision.distance, -separation);
+	}
+
+	if (collision.manifoldSize == 0)
+	{
+		return false;
+	}
+
+	collision.point /= (float)collision.manifoldSize;
+	collision.normal = normal;
+	return true;
+}
+
+// SAT for polygons of TCountA and TCountB vertices, 0 for any count up to SAT_MAX_VERTICES
+template<size_t TCountA, size_t TCountB>
+static bool CollideSAT(const CPolygon& polyA, const CPolygon& polyB, SCollision& collision, SNarrowPhaseCache* cache)
+{
+	TWorldPolygon<TCountA> worldA(polyA);
+	TWorldPolygon<TCountB> worldB(polyB);
+
+	// Temporal coherence : last frame separating axis is very likely to still separate
+	if (cache && cache->axisOwner)
+	{
+		bool separated = (cache->axisOwner == &polyA)
+			? (cache->axisEdge < worldA.count && EdgeSeparation(worldA, cache->axisEdge, worldB) > 0.0f)
+			: (cache->axisEdge < worldB.count && EdgeSeparation(worldB, cache->axisEdge, worldA) > 0.0f);
+		if (separated)
+		{
+			return false;
+		}
+	}
+
+	size_t edgeA = 0, edgeB = 0;
+	float separationA = FindMaxSeparation(worldA, worldB, edgeA);
+	if (separationA > 0.0f)
+	{
+		if (cache)
+		{
+			cache->axisOwner = &polyA;
+			cache->axisEdge = edgeA;
+		}
+		return false;
+	}
+
+	float separationB = FindMaxSeparation(worldB, worldA, edgeB);
+	if (separationB > 0.0f)
+	{
+		if (cache)
+		{
+			cache->axisOwner = &polyB;
+			cache->axisEdge = edgeB;
+		}
+		return false;
+	}
+
+	if (cache)
+	{
+		cache->axisOwner = nullptr;
+	}
+
+	// Reference face is the least penetrating one, prefer A to avoid flip-flopping
+	bool flip = separationB > separationA + 0.001f;
+	return flip ? BuildManifold(worldB, worldA, edgeB, true, collision) : BuildManifold(worldA, worldB, edgeA, false, collision);
+}
+
+bool	CollidePolygonsSAT(const CPolygon& polyA, const CPolygon& polyB, SCollision& collision, SNarrowPhaseCache* cache)
+{
+	// Triangles and boxes make most of the scenes
+	size_t countA = polyA.GetPoints().size();
+	size_t countB = polyB.GetPoints().size();
+	switch (countA * 16 + countB)
+	{
+		case 3 * 16 + 3:	return CollideSAT<3, 3>(polyA, polyB, collision, cache);
+		case 3 * 16 + 4:	return CollideSAT<3, 4>(polyA, polyB, collision, cache);
+		case 4 * 16 + 3:	return CollideSAT<4, 3>(polyA, polyB, collision, cache);
+		case 4 * 16 + 4:	return CollideSAT<4, 4>(polyA, polyB, collision, cache);
+		default:			return CollideSAT<0, 0>(polyA, polyB, collision, cache);
+	}
+}
+
+bool	Collide(const CPolygon& polyA, const CPolygon& polyB, SCollision& collision, SNarrowPhaseCache* cache)
+{
+	if (!polyA.GetShape() || !polyB.GetShape())
+	{
+		return false;
+	}
+
+	TCollisionKernel kernel = gCollisionMatrix[(int)polyA.GetShape()->GetType()][(int)polyB.GetShape()->GetType()];
+	return kernel(polyA, polyB, collision, cache);
+}
+
+EPairClass	GetPairClass(const CPolygon& polyA, const CPolygon& polyB)
+{
+	const CShape* shapeA = polyA.GetShape().get();
+	const CShape* shapeB = polyB.GetShape().get();
+	if (!shapeA || !shapeB)
+	{
+		return EPairClass::Generic;
+	}
+
+	if (shapeA->GetType() == EShapeType::Circle && shapeB->GetType() == EShapeType::Circle)
+	{
+		return EPairClass::CircleCircle;
+	}
+	if (shapeA->GetType() == EShapeType::Polygon && shapeB->GetType() == EShapeType::Polygon && shapeA->IsBox() && shapeB->IsBox())
+	{
+		return EPairClass::BoxBox;
+	}
+	return EPairClass::Generic;
+}
+
+// The batch kernels below work on a single __m128 per array
+static_assert(NARROW_PHASE_BATCH_SIZE == 4, "batch kernels are written for one 4 lane SSE register");
+
+// Structure of arrays of a batch, unused lanes repeat the first pair
+struct SBatchLanes
+{
+	SBatchLanes(const SCollision* const* collisions, size_t count)
+	{
+		for (size_t lane = 0; lane < NARROW_PHASE_BATCH_SIZE; ++lane)
+		{
+			const SCollision& collision = *collisions[(lane < count) ? lane : 0];
+			Gather(*collision.polyA, lane, positionAX, positionAY, rotationA);
+			Gather(*collision.polyB, lane, positionBX, positionBY, rotationB);
+		}
+	}
+
+	static void	Gather(const CPolygon& poly, size_t lane, float* positionX, float* positionY, float(*rotation)[NARROW_PHASE_BATCH_SIZE])
+	{
+		positionX[lane] = poly.position.x;
+		positionY[lane] = poly.position.y;
+		rotation[0][lane] = poly.rotation.X.x;
+		rotation[1][lane] = poly.rotation.X.y;
+		rotation[2][lane] = poly.rotation.Y.x;
+		rotation[3][lane] = poly.rotation.Y.y;
+	}
+
+	float	positionAX[NARROW_PHASE_BATCH_SIZE], positionAY[NARROW_PHASE_BATCH_SIZE];
+	float	positionBX[NARROW_PHASE_BATCH_SIZE], positionBY[NARROW_PHASE_BATCH_SIZE];
+	float	rotationA[4][NARROW_PHASE_BATCH_SIZE]; // X.x, X.y, Y.x, Y.y
+	float	rotationB[4][NARROW_PHASE_BATCH_SIZE];
+};
+
+static __m128	AbsPS(__m128 value)
+{
+	return _mm_andnot_ps(_mm_set1_ps(-0.0f), value);
+}
+
+void	CollideCirclesBatch(SCollision* const* collisions, size_t count, bool* colliding)
+{
+	SBatchLanes lanes(collisions, count);
+
+	float radiusA[NARROW_PHASE_BATCH_SIZE], radiusB[NARROW_PHASE_BATCH_SIZE];
+	for (size_t lane = 0; lane < NARROW_PHASE_BATCH_SIZE; ++lane)
+	{
+		const SCollision& collision = *collisions[(lane < count) ? lane : 0];
+		radiusA[lane] = collision.polyA->GetShape()->GetRadius();
+		radiusB[lane] = collision.polyB->GetShape()->GetRadius();
+	}
+
+	// Same operations as CollideCircles, lane by lane
+	__m128 rA = _mm_loadu_ps(radiusA);
+	__m128 radii = _mm_add_ps(rA, _mm_loadu_ps(radiusB));
+	__m128 diffX = _mm_sub_ps(_mm_loadu_ps(lanes.positionBX), _mm_loadu_ps(lanes.positionAX));
+	__m128 diffY = _mm_sub_ps(_mm_loadu_ps(lanes.positionBY), _mm_loadu_ps(lanes.positionAY));
+	__m128 sqrDist = _mm_add_ps(_mm_mul_ps(diffX, diffX), _mm_mul_ps(diffY, diffY));
+	int overlapMask = _mm_movemask_ps(_mm_cmple_ps(sqrDist, _mm_mul_ps(radii, radii)));
+
+	__m128 dist = _mm_sqrt_ps(sqrDist);
+	__m128 coincident = _mm_cmpeq_ps(dist, _mm_setzero_ps());
+	__m128 normalX = _mm_andnot_ps(coincident, _mm_div_ps(diffX, dist));
+	__m128 normalY = _mm_or_ps(_mm_and_ps(coincident, _mm_set1_ps(1.0f)), _mm_andnot_ps(coincident, _mm_div_ps(diffY, dist)));
+	__m128 penetration = _mm_sub_ps(radii, dist);
+	__m128 offset = _mm_sub_ps(rA, _mm_mul_ps(penetration, _mm_set1_ps(0.5f)));
+	__m128 pointX = _mm_add_ps(_mm_loadu_ps(lanes.positionAX), _mm_mul_ps(normalX, offset));
+	__m128 pointY = _mm_add_ps(_mm_loadu_ps(lanes.positionAY), _mm_mul_ps(normalY, offset));
+
+	float nX[NARROW_PHASE_BATCH_SIZE], nY[NARROW_PHASE_BATCH_SIZE], pX[NARROW_PHASE_BATCH_SIZE], pY[NARROW_PHASE_BATCH_SIZE], depth[NARROW_PHASE_BATCH_SIZE];
+	_mm_storeu_ps(nX, normalX);
+	_mm_storeu_ps(nY, normalY);
+	_mm_storeu_ps(pX, pointX);
+	_mm_storeu_ps(pY, pointY);
+	_mm_storeu_ps(depth, penetration);
+
+	for (size_t lane = 0; lane < count; ++lane)
+	{
+		colliding[lane] = (overlapMask & (1 << lane)) != 0;
+		if (colliding[lane])
+		{
+			SetSingleContact(*collisions[lane], Vec2(pX[lane], pY[lane]), Vec2(nX[lane], nY[lane]), depth[lane], 0);
+		}
+	}
+}
+
+void	CollideBoxesBatch(SCollision* const* collisions, SNarrowPhaseCache* const* caches, size_t count, bool* colliding)
+{
+	SBatchLanes lanes(collisions, count);
+
+	float localAxisAX[NARROW_PHASE_BATCH_SIZE], localAxisAY[NARROW_PHASE_BATCH_SIZE], halfAX[NARROW_PHASE_BATCH_SIZE], halfAY[NARROW_PHASE_BATCH_SIZE];
+	float localAxisBX[NARROW_PHASE_BATCH_SIZE], localAxisBY[NARROW_PHASE_BATCH_SIZE], halfBX[NARROW_PHASE_BATCH_SIZE], halfBY[NARROW_PHASE_BATCH_SIZE];
+	for (size_t lane = 0; lane < NARROW_PHASE_BATCH_SIZE; ++lane)
+	{
+		const SCollision& collision = *collisions[(lane < count) ? lane : 0];
+		const CShape& shapeA = *collision.polyA->GetShape();
+		const CShape& shapeB = *collision.polyB->GetShape();
+		localAxisAX[lane] = shapeA.GetBoxAxis().x;
+		localAxisAY[lane] = shapeA.GetBoxAxis().y;
+		halfAX[lane] = shapeA.GetBoxHalfExtents().x;
+		halfAY[lane] = shapeA.GetBoxHalfExtents().y;
+		localAxisBX[lane] = shapeB.GetBoxAxis().x;
+		localAxisBY[lane] = shapeB.GetBoxAxis().y;
+		halfBX[lane] = shapeB.GetBoxHalfExtents().x;
+		halfBY[lane] = shapeB.GetBoxHalfExtents().y;
+	}
+
+	// World box axes u, their normal v is (-u.y, u.x)
+	__m128 axisAX = _mm_loadu_ps(localAxisAX), axisAY = _mm_loadu_ps(localAxisAY);
+	__m128 uAX = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(lanes.rotationA[0]), axisAX), _mm_mul_ps(_mm_loadu_ps(lanes.rotationA[2]), axisAY));
+	__m128 uAY = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(lanes.rotationA[1]), axisAX), _mm_mul_ps(_mm_loadu_ps(lanes.rotationA[3]), axisAY));
+	__m128 axisBX = _mm_loadu_ps(localAxisBX), axisBY = _mm_loadu_ps(localAxisBY);
+	__m128 uBX = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(lanes.rotationB[0]), axisBX), _mm_mul_ps(_mm_loadu_ps(lanes.rotationB[2]), axisBY));
+	__m128 uBY = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(lanes.rotationB[1]), axisBX), _mm_mul_ps(_mm_loadu_ps(lanes.rotationB[3]), axisBY));
+
+	__m128 hAX = _mm_loadu_ps(halfAX), hAY = _mm_loadu_ps(halfAY);
+	__m128 hBX = _mm_loadu_ps(halfBX), hBY = _mm_loadu_ps(halfBY);
+	__m128 dX = _mm_sub_ps(_mm_loadu_ps(lanes.positionBX), _mm_loadu_ps(lanes.positionAX));
+	__m128 dY = _mm_sub_ps(_mm_loadu_ps(lanes.positionBY), _mm_loadu_ps(lanes.positionAY));
+
+	// uA.uB = vA.vB and uA.vB = -vA.uB, so two dot products give every cross projection
+	__m128 absCos = AbsPS(_mm_add_ps(_mm_mul_ps(uAX, uBX), _mm_mul_ps(uAY, uBY)));
+	__m128 absSin = AbsPS(_mm_sub_ps(_mm_mul_ps(uAY, uBX), _mm_mul_ps(uAX, uBY)));
+
+	// Separation on each axis : center distance minus both projected half extents
+	__m128 dUA = AbsPS(_mm_add_ps(_mm_mul_ps(dX, uAX), _mm_mul_ps(dY, uAY)));
+	__m128 dVA = AbsPS(_mm_sub_ps(_mm_mul_ps(dY, uAX), _mm_mul_ps(dX, uAY)));
+	__m128 dUB = AbsPS(_mm_add_ps(_mm_mul_ps(dX, uBX), _mm_mul_ps(dY, uBY)));
+	__m128 dVB = AbsPS(_mm_sub_ps(_mm_mul_ps(dY, uBX), _mm_mul_ps(dX, uBY)));
+	__m128 sepUA = _mm_sub_ps(_mm_sub_ps(dUA, hAX), _mm_add_ps(_mm_mul_ps(hBX, absCos), _mm_mul_ps(hBY, absSin)));
+	__m128 sepVA = _mm_sub_ps(_mm_sub_ps(dVA, hAY), _mm_add_ps(_mm_mul_ps(hBX, absSin), _mm_mul_ps(hBY, absCos)));
+	__m128 sepUB = _mm_sub_ps(_mm_sub_ps(dUB, hBX), _mm_add_ps(_mm_mul_ps(hAX, absCos), _mm_mul_ps(hAY, absSin)));
+	__m128 sepVB = _mm_sub_ps(_mm_sub_ps(dVB, hBY), _mm_add_ps(_mm_mul_ps(hAX, absSin), _mm_mul_ps(hAY, absCos)));
+	__m128 separation = _mm_max_ps(_mm_max_ps(sepUA, sepVA), _mm_max_ps(sepUB, sepVB));
+	int separatedMask = _mm_movemask_ps(_mm_cmpgt_ps(separation, _mm_setzero_ps()));
+
+	// Most broad phase pairs stop here, the others need contact points and feature ids
+	for (size_t lane = 0; lane < count; ++lane)
+	{
+		colliding[lane] = !(separatedMask & (1 << lane))
+			&& CollideSAT<4, 4>(*collisions[lane]->polyA, *collisions[lane]->polyB, *collisions[lane], caches[lane]);
+	}
+}
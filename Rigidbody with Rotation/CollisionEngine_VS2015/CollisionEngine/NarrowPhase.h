@@ -0,0 +1,49 @@
+#ifndef _NARROW_PHASE_H_
+#define _NARROW_PHASE_H_
+
+#include "Polygon.h"
+#include "Collision.h"
+
+// Bigger polygons go through Minkowski difference and GJK, with a single contact from the closest edge of the difference
+#define SAT_MAX_VERTICES 8
+
+// Collision kernels : collision.polyA and collision.polyB must be set
+// On collision, normal goes from A to B and distance is the penetration depth
+// cache is optional, it keeps the separating axis (SAT) and search direction (GJK) from last frame
+bool	CollideCircles(const CPolygon& circleA, const CPolygon& circleB, SCollision& collision, SNarrowPhaseCache* cache);
+bool	CollidePolygonCircle(const CPolygon& polyA, const CPolygon& circleB, SCollision& collision, SNarrowPhaseCache* cache);
+bool	CollideCirclePolygon(const CPolygon& circleA, const CPolygon& polyB, SCollision& collision, SNarrowPhaseCache* cache);
+bool	CollidePolygons(const CPolygon& polyA, const CPolygon& polyB, SCollision& collision, SNarrowPhaseCache* cache);
+
+// Children of the compound overlapping the other polygon go through their own kernel, the deepest contacts are kept
+bool	CollideCompound(const CPolygon& compoundA, const CPolygon& polyB, SCollision& collision, SNarrowPhaseCache* cache);
+bool	CollideWithCompound(const CPolygon& polyA, const CPolygon& compoundB, SCollision& collision, SNarrowPhaseCache* cache);
+
+// Separating axis test over edge normals, for polygons up to SAT_MAX_VERTICES
+// Triangle and box pairs go through kernels compiled for their vertex counts, without loops over a runtime count
+bool	CollidePolygonsSAT(const CPolygon& polyA, const CPolygon& polyB, SCollision& collision, SNarrowPhaseCache* cache);
+
+// Pick the kernel from the shape types collision matrix
+bool	Collide(const CPolygon& polyA, const CPolygon& polyB, SCollision& collision, SNarrowPhaseCache* cache = nullptr);
+
+// Pairs of the common shape classes are bucketed and collided several at once, one pair per SSE lane
+// Fixed by the width of an SSE register, not tunable
+#define NARROW_PHASE_BATCH_SIZE	4
+
+enum class EPairClass : int
+{
+	Generic = 0, // through Collide()
+	CircleCircle,
+	BoxBox,
+
+	Count,
+};
+
+EPairClass	GetPairClass(const CPolygon& polyA, const CPolygon& polyB);
+
+// Up to NARROW_PHASE_BATCH_SIZE pairs of the class, colliding[i] is what the single pair kernel returns for collisions[i]
+void	CollideCirclesBatch(SCollision* const* collisions, size_t count, bool* colliding);
+// The 4 box axes are tested in SIMD, manifolds of the overlapping pairs are then built by the box-box SAT kernel
+void	CollideBoxesBatch(SCollision* const* collisions, SNarrowPhaseCache* const* caches, size_t count, bool* colliding);
+
+#endif
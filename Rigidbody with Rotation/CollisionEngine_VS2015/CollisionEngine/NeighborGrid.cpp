@@ -0,0 +1,66 @@
+#include "NeighborGrid.h"
+
+// Keep the grid size reasonable if a few points fly away
+#define NEIGHBOR_GRID_MAX_CELLS	(1 << 22)
+
+void	CNeighborGrid::Build(const float* positionsX, const float* positionsY, size_t count, float cellSize)
+{
+	AABB bounds;
+	bounds.Center((count > 0) ? Vec2(positionsX[0], positionsY[0]) : Vec2());
+	for (size_t i = 1; i < count; ++i)
+	{
+		bounds.Extend(Vec2(positionsX[i], positionsY[i]));
+	}
+
+	m_origin = bounds.min;
+	m_invCellSize = 1.0f / cellSize;
+	Vec2 size = bounds.max - bounds.min;
+	m_width = Max((int)(size.x * m_invCellSize) + 1, 1);
+	m_height = Max((int)(size.y * m_invCellSize) + 1, 1);
+	while ((size_t)m_width * (size_t)m_height > NEIGHBOR_GRID_MAX_CELLS)
+	{
+		m_invCellSize *= 0.5f;
+		m_width = Max((int)(size.x * m_invCellSize) + 1, 1);
+		m_height = Max((int)(size.y * m_invCellSize) + 1, 1);
+	}
+
+	// Counting sort of the points by cell
+	m_cellStart.assign(m_width * m_height + 1, 0);
+	m_pointCells.resize(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		int x, y;
+		GetCell(positionsX[i], positionsY[i], x, y);
+		m_pointCells[i] = y * m_width + x;
+		++m_cellStart[m_pointCells[i] + 1];
+	}
+
+	for (size_t cell = 1; cell < m_cellStart.size(); ++cell)
+	{
+		m_cellStart[cell] += m_cellStart[cell - 1];
+	}
+
+	m_sortedIndices.resize(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		m_sortedIndices[m_cellStart[m_pointCells[i]]++] = (uint32_t)i;
+	}
+
+	// Filling shifted each start to the next cell one
+	for (size_t cell = m_cellStart.size() - 1; cell > 0; --cell)
+	{
+		m_cellStart[cell] = m_cellStart[cell - 1];
+	}
+	m_cellStart[0] = 0;
+}
+
+const std::vector<uint32_t>&	CNeighborGrid::GetSortedIndices() const
+{
+	return m_sortedIndices;
+}
+
+void	CNeighborGrid::GetCell(float positionX, float positionY, int& x, int& y) const
+{
+	x = Clamp((int)((positionX - m_origin.x) * m_invCellSize), 0, m_width - 1);
+	y = Clamp((int)((positionY - m_origin.y) * m_invCellSize), 0, m_height - 1);
+}
@@ -0,0 +1,53 @@
+#ifndef _NEIGHBOR_GRID_H_
+#define _NEIGHBOR_GRID_H_
+
+#include <stdint.h>
+#include <vector>
+
+#include "Maths.h"
+
+// Cell-linked uniform grid over points, rebuilt each step
+// Cell size must be at least the interaction radius, so neighbors are in the 3x3 cells around a point
+// After Build(), the caller reorders its arrays with GetSortedIndices() : points of a cell are then contiguous
+class CNeighborGrid
+{
+public:
+	void	Build(const float* positionsX, const float* positionsY, size_t count, float cellSize);
+
+	// Sorted point i was point GetSortedIndices()[i] before sorting
+	const std::vector<uint32_t>&	GetSortedIndices() const;
+
+	// Call functor(begin, end) for each range of sorted points in the 3x3 cells around position
+	template<typename TFunctor>
+	void	ForEachNeighborRange(float positionX, float positionY, TFunctor functor) const
+	{
+		int x, y;
+		GetCell(positionX, positionY, x, y);
+
+		int minX = Max(x - 1, 0);
+		int maxX = Min(x + 1, m_width - 1);
+		for (int row = Max(y - 1, 0); row <= Min(y + 1, m_height - 1); ++row)
+		{
+			// Cells of a row are contiguous, one range per row
+			uint32_t begin = m_cellStart[row * m_width + minX];
+			uint32_t end = m_cellStart[row * m_width + maxX + 1];
+			if (begin != end)
+			{
+				functor(begin, end);
+			}
+		}
+	}
+
+private:
+	void	GetCell(float positionX, float positionY, int& x, int& y) const;
+
+	Vec2	m_origin;
+	float	m_invCellSize = 1.0f;
+	int		m_width = 0, m_height = 0;
+
+	std::vector<uint32_t>	m_cellStart; // first sorted point of each cell, plus one past the last cell
+	std::vector<uint32_t>	m_pointCells;
+	std::vector<uint32_t>	m_sortedIndices;
+};
+
+#endif
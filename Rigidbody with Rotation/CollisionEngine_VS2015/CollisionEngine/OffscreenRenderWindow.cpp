@@ -0,0 +1,52 @@
+#include "OffscreenRenderWindow.h"
+
+#include <stdio.h>
+
+#include "GlobalVariables.h"
+#include "Renderer.h"
+#include "SceneManager.h"
+#include "SoftwareRenderBackend.h"
+
+COffscreenRenderWindow::COffscreenRenderWindow(int width, int height, CSoftwareRenderBackend* backend, const SOffscreenParams& params)
+	: CRenderWindow(width, height), m_backend(backend), m_params(params)
+{
+}
+
+void COffscreenRenderWindow::Init()
+{
+	gVars->pRenderer->SetFixedFrameTime(m_params.frameTime);
+	gVars->pRenderer->Init();
+	if (m_params.sceneIndex != 0)
+	{
+		gVars->pSceneManager->LoadScene(m_params.sceneIndex);
+	}
+
+	float physicDuration = 0.0f;
+	float renderDuration = 0.0f;
+
+	for (size_t frame = 0; frame < m_params.frameCount; ++frame)
+	{
+		gVars->pRenderer->Update();
+		physicDuration += gVars->pRenderer->GetLastPhysicDuration();
+		renderDuration += gVars->pRenderer->GetLastRenderDuration();
+
+		if (!m_params.framePrefix.empty() && m_params.saveInterval > 0 && frame % m_params.saveInterval == 0)
+		{
+			char suffix[32];
+			snprintf(suffix, sizeof(suffix), "%05u.ppm", (unsigned int)frame);
+			if (!m_backend->SaveFrame(m_params.framePrefix + suffix))
+			{
+				printf("Could not write frame %u\n", (unsigned int)frame);
+			}
+		}
+	}
+
+	if (m_params.frameCount > 0)
+	{
+		float frameCount = (float)m_params.frameCount;
+		printf("%u frames, physic: %.3f ms/frame, render: %.3f ms/frame\n", (unsigned int)m_params.frameCount,
+			1000.0f * physicDuration / frameCount, 1000.0f * renderDuration / frameCount);
+	}
+
+	gVars->pRenderer->Reset();
+}
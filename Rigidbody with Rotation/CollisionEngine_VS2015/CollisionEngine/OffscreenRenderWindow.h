@@ -0,0 +1,38 @@
+#ifndef _RENDER_WINDOW_OFFSCREEN_H_
+#define _RENDER_WINDOW_OFFSCREEN_H_
+
+#include <string>
+
+#include "RenderWindow.h"
+
+class CSoftwareRenderBackend;
+
+struct SOffscreenParams
+{
+	size_t		sceneIndex = 0;
+	size_t		frameCount = 300;
+	float		frameTime = 1.0f / 60.0f; // fixed, so runs can be compared
+	std::string	framePrefix; // frames are written as <framePrefix>00042.ppm, none when empty
+	size_t		saveInterval = 1;
+};
+
+// No window and no input, renders a fixed number of frames with a CSoftwareRenderBackend
+// Prints the average physic and render durations at the end
+class COffscreenRenderWindow : public CRenderWindow
+{
+public:
+	COffscreenRenderWindow(int width, int height, CSoftwareRenderBackend* backend, const SOffscreenParams& params);
+
+	virtual void	Init() override;
+
+	virtual Vec2	GetMousePos() override				{ return Vec2(); }
+	virtual bool	GetMouseButton(int button) override	{ return false; }
+	virtual bool	IsPressingKey(Key key) override		{ return false; }
+	virtual bool	JustPressedKey(Key key) override	{ return false; }
+
+private:
+	CSoftwareRenderBackend*	m_backend;
+	SOffscreenParams		m_params;
+};
+
+#endif
@@ -0,0 +1,118 @@
+#include "PairCache.h"
+
+void	CPairCache::Clear()
+{
+	m_pairs.clear();
+	m_activePairs.clear();
+	m_addedCount = 0;
+	m_removedCount = 0;
+}
+
+void	CPairCache::Update(const std::vector<SPolygonPair>& broadPhasePairs)
+{
+	++m_frame;
+	m_addedCount = 0;
+	m_removedCount = 0;
+	m_activePairs.clear();
+
+	for (const SPolygonPair& polyPair : broadPhasePairs)
+	{
+		// Looked up first, emplace would allocate a node even for a pair already there
+		SPairKey key(polyPair.polyA.get(), polyPair.polyB.get());
+		auto it = m_pairs.find(key);
+		if (it == m_pairs.end())
+		{
+			it = m_pairs.emplace(key, SCachedPair(polyPair.polyA, polyPair.polyB)).first;
+			OnPairAdded(it->second);
+		}
+		else
+		{
+			// Keep the order given by the broad phase
+			it->second.polyA = polyPair.polyA;
+			it->second.polyB = polyPair.polyB;
+		}
+		SCachedPair& pair = it->second;
+
+		pair.lastFrame = m_frame;
+		m_activePairs.push_back(&pair);
+	}
+
+	for (auto it = m_pairs.begin(); it != m_pairs.end();)
+	{
+		if (it->second.lastFrame != m_frame)
+		{
+			// Erasing releases the polygons and the narrow phase data of the pair
+			++m_removedCount;
+			it = m_pairs.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+
+const std::vector<SCachedPair*>&	CPairCache::GetActivePairs() const
+{
+	return m_activePairs;
+}
+
+SCachedPair*	CPairCache::Find(const CPolygon* polyA, const CPolygon* polyB)
+{
+	auto it = m_pairs.find(SPairKey(polyA, polyB));
+	return (it != m_pairs.end()) ? &it->second : nullptr;
+}
+
+void	CPairCache::UpdateManifold(SCachedPair& pair, SCollision& collision)
+{
+	for (size_t i = 0; i < collision.manifoldSize; ++i)
+	{
+		SContactInfo& contact = collision.manifold[i];
+		for (size_t j = 0; j < pair.manifoldSize; ++j)
+		{
+			if (pair.manifold[j] == contact)
+			{
+				contact.normalImpulse = pair.manifold[j].normalImpulse;
+				contact.tangentImpulse = pair.manifold[j].tangentImpulse;
+				break;
+			}
+		}
+	}
+
+	pair.colliding = true;
+	pair.manifoldSize = collision.manifoldSize;
+	for (size_t i = 0; i < collision.manifoldSize; ++i)
+	{
+		pair.manifold[i] = collision.manifold[i];
+	}
+}
+
+void	CPairCache::ClearManifold(SCachedPair& pair)
+{
+	pair.colliding = false;
+	pair.manifoldSize = 0;
+}
+
+size_t	CPairCache::GetPairCount() const
+{
+	return m_pairs.size();
+}
+
+size_t	CPairCache::GetAddedCount() const
+{
+	return m_addedCount;
+}
+
+size_t	CPairCache::GetRemovedCount() const
+{
+	return m_removedCount;
+}
+
+void	CPairCache::OnPairAdded(SCachedPair& pair)
+{
+	++m_addedCount;
+
+	pair.narrowPhase = SNarrowPhaseCache();
+	pair.narrowPhase.searchDirection = pair.polyB->position - pair.polyA->position;
+	ClearManifold(pair);
+}
@@ -0,0 +1,62 @@
+#ifndef _PAIR_CACHE_H_
+#define _PAIR_CACHE_H_
+
+#include <vector>
+#include <unordered_map>
+
+#include "Collision.h"
+
+// Everything known about a pair of polygons while the broad phase reports it
+struct SCachedPair
+{
+	SCachedPair(CPolygonPtr _polyA, CPolygonPtr _polyB) : polyA(_polyA), polyB(_polyB){}
+
+	CPolygonPtr			polyA, polyB;
+
+	SNarrowPhaseCache	narrowPhase;
+
+	// Last frame manifold, with accumulated impulses
+	bool				colliding = false;
+	size_t				manifoldSize = 0;
+	SContactInfo		manifold[2];
+
+	size_t				lastFrame = 0;
+};
+
+// Persistent pair key -> cached pair map
+// Pairs are added when the broad phase starts reporting them and removed when it stops
+class CPairCache
+{
+public:
+	void	Clear();
+
+	// Diff the broad phase pairs against the cached ones, new pairs are prepared by OnPairAdded, stale ones erased
+	void	Update(const std::vector<SPolygonPair>& broadPhasePairs);
+
+	// Pairs reported by the broad phase this frame, in the same order
+	const std::vector<SCachedPair*>&	GetActivePairs() const;
+
+	SCachedPair*	Find(const CPolygon* polyA, const CPolygon* polyB);
+
+	// Copy accumulated impulses of matching feature ids from last manifold into the new one, then keep it
+	void	UpdateManifold(SCachedPair& pair, SCollision& collision);
+	void	ClearManifold(SCachedPair& pair);
+
+	size_t	GetPairCount() const;
+	size_t	GetAddedCount() const;
+	size_t	GetRemovedCount() const;
+
+private:
+	// No manifold yet, GJK starts searching along the line between the centers
+	void	OnPairAdded(SCachedPair& pair);
+
+	// unordered_map nodes never move, so active pairs pointers stay valid until the pair is removed
+	std::unordered_map<SPairKey, SCachedPair, SPairKeyHash>	m_pairs;
+	std::vector<SCachedPair*>	m_activePairs;
+
+	size_t	m_frame = 0;
+	size_t	m_addedCount = 0;
+	size_t	m_removedCount = 0;
+};
+
+#endif
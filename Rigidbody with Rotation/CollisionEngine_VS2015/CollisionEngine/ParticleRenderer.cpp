@@ -0,0 +1,53 @@
+#include "ParticleRenderer.h"
+
+#include "Maths.h"
+#include "GlobalVariables.h"
+#include "Renderer.h"
+#include "RenderWindow.h"
+
+CParticleRenderer::CParticleRenderer()
+	: m_vertexBuffer(GL_ARRAY_BUFFER)
+{
+}
+
+void	CParticleRenderer::Draw(const float* positionsX, const float* positionsY, size_t count, float radius, float r, float g, float b)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	m_vertices.resize(2 * count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		m_vertices[2 * i] = positionsX[i];
+		m_vertices[2 * i + 1] = positionsY[i];
+	}
+
+	float pixelsPerUnit = (float)gVars->pRenderWindow->Getheight() / gVars->pRenderer->GetWorldHeight();
+
+	glPushMatrix();
+	glTranslatef(0.0f, 0.0f, -1.0f);
+
+	glEnable(GL_POINT_SMOOTH);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	glPointSize(Max(2.0f * radius * pixelsPerUnit, 1.0f));
+	glColor3f(r, g, b);
+
+	size_t offset = m_vertexBuffer.Upload(m_vertices.data(), sizeof(float) * m_vertices.size());
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glVertexPointer(2, GL_FLOAT, 0, (void*)offset);
+
+	glDrawArrays(GL_POINTS, 0, (GLsizei)count);
+
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	glDisable(GL_BLEND);
+	glDisable(GL_POINT_SMOOTH);
+
+	glPopMatrix();
+
+	m_vertexBuffer.EndFrame();
+}
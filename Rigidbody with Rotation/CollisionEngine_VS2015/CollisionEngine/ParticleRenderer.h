@@ -0,0 +1,27 @@
+#ifndef _PARTICLE_RENDERER_H_
+#define _PARTICLE_RENDERER_H_
+
+#include <GL/glew.h>
+#include <vector>
+
+#include "StreamBuffer.h"
+
+// Draw many particles with a single call
+// Positions are streamed into one vertex buffer each frame (see CStreamBuffer) and drawn as round points
+class CParticleRenderer
+{
+public:
+	CParticleRenderer();
+
+	CParticleRenderer(const CParticleRenderer&) = delete;
+	CParticleRenderer& operator=(const CParticleRenderer&) = delete;
+
+	// radius is in world units
+	void	Draw(const float* positionsX, const float* positionsY, size_t count, float radius, float r, float g, float b);
+
+private:
+	CStreamBuffer		m_vertexBuffer;
+	std::vector<float>	m_vertices; // interleaved x, y
+};
+
+#endif
@@ -1,20 +1,28 @@
 #include "PhysicEngine.h"
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include "GlobalVariables.h"
 #include "World.h"
 #include "Renderer.h" // for debugging only
 #include "Timer.h"
+#include "NarrowPhase.h"
 
 #include "BroadPhase.h"
 #include "SPBroadPhase.h"
 
+// Bodies moving more than this fraction of their bounding radius in a step get continuous collision
+#define CCD_MOTION_THRESHOLD	1.0f
+// Bounce at a time of impact
+#define CCD_RESTITUTION			0.6f
 
 void	CPhysicEngine::Reset()
 {
 	m_pairsToCheck.clear();
 	m_collidingPairs.clear();
+	m_pairCache.Clear();
+	m_sweeps.clear();
 
 	m_active = true;
 
@@ -35,14 +43,26 @@ void	CPhysicEngine::DetectCollisions()
 	if (gVars->bDebug)
 	{
 		gVars->pRenderer->DisplayText("Collision broadphase duration " + std::to_string(timer.GetDuration() * 1000.0f) + " ms");
+		gVars->pRenderer->DisplayText("Cached pairs " + std::to_string(m_pairCache.GetPairCount()) + ", added " + std::to_string(m_pairCache.GetAddedCount()) + ", removed " + std::to_string(m_pairCache.GetRemovedCount()));
 	}
 
+	SolveTimeOfImpacts();
+
 	timer.Start();
 	CollisionNarrowPhase();
 	timer.Stop();
 	if (gVars->bDebug)
 	{
 		gVars->pRenderer->DisplayText("Collision narrowphase duration " + std::to_string(timer.GetDuration() * 1000.0f) + " ms, collisions : " + std::to_string(m_collidingPairs.size()));
+
+		for (const SCollision& collision : m_collidingPairs)
+		{
+			for (size_t i = 0; i < collision.manifoldSize; ++i)
+			{
+				const SContactInfo& contact = collision.manifold[i];
+				gVars->pRenderer->DrawLine(contact.point, contact.point + contact.normal * Max(contact.penetration, 0.2f), 1.0f, 0.3f, 0.3f, EDebugCategory::Contact);
+			}
+		}
 	}
 }
 
@@ -51,14 +71,20 @@ void	CPhysicEngine::Step(float deltaTime)
 {
 	deltaTime = Min(deltaTime, 1.0f / 15.0f);
 
+	m_frameArena.Reset();
+
 	if (!m_active)
 	{
+		// Still needed for rendering and world queries
+		gVars->pWorld->UpdateTransforms();
+		m_broadPhase->Update();
 		return;
 	}
 
 	Vec2 gravity(0, -9.8f);
 	float elasticity = 0.6f;
 
+	m_sweeps.clear();
 	gVars->pWorld->ForEachPolygon([&](CPolygonPtr poly)
 	{
 		if (poly->density == 0.0f)
@@ -66,12 +92,43 @@ void	CPhysicEngine::Step(float deltaTime)
 			return;
 		}
 
-		poly->rotation.Rotate(RAD2DEG(poly->angularVelocity * deltaTime));
-		poly->position += poly->speed * deltaTime;
+		SSweep sweep;
+		sweep.polygon = poly;
+		sweep.startPosition = poly->position;
+		sweep.startRotation = poly->rotation;
+		sweep.translation = poly->speed * deltaTime;
+		sweep.rotation = RAD2DEG(poly->angularVelocity * deltaTime);
+		if (NeedsContinuousCollision(sweep))
+		{
+			m_sweeps.push_back(sweep);
+		}
+
+		poly->rotation.Rotate(sweep.rotation);
+		poly->position += sweep.translation;
 		poly->speed += gravity * deltaTime;
 	});
 
+	gVars->pWorld->UpdateTransforms();
+	ExtendSweptAABBs();
 	DetectCollisions();
+	SolveContacts(deltaTime, elasticity);
+
+	m_trajectoryRecorder.RecordStep(deltaTime);
+}
+
+CTrajectoryRecorder&	CPhysicEngine::GetTrajectoryRecorder()
+{
+	return m_trajectoryRecorder;
+}
+
+CFrameArena&	CPhysicEngine::GetFrameArena()
+{
+	return m_frameArena;
+}
+
+const IBroadPhase*	CPhysicEngine::GetBroadPhase() const
+{
+	return m_broadPhase;
 }
 
 void	CPhysicEngine::CollisionBroadPhase()
@@ -83,6 +140,7 @@ void	CPhysicEngine::CollisionBroadPhase()
 	}
 
 	m_pairsToCheck.clear();
+	m_broadPhase->Update();
 	m_broadPhase->GetCollidingPairsToCheck(m_pairsToCheck);
 
 	for (const SPolygonPair& polyPair : m_pairsToCheck)
@@ -90,24 +148,215 @@ void	CPhysicEngine::CollisionBroadPhase()
 		polyPair.polyA->GetOwnAABB()->bIsColliding = true;
 		polyPair.polyB->GetOwnAABB()->bIsColliding = true;
 	}
+
+	m_pairCache.Update(m_pairsToCheck);
+}
+
+bool	CPhysicEngine::NeedsContinuousCollision(const SSweep& sweep) const
+{
+	if (sweep.polygon->bullet)
+	{
+		return true;
+	}
+
+	float radius = sweep.polygon->GetShape()->GetBoundingRadius();
+	float motion = sweep.translation.GetLength() + fabsf(DEG2RAD(sweep.rotation)) * radius;
+	return motion > CCD_MOTION_THRESHOLD * radius;
+}
+
+void	CPhysicEngine::ExtendSweptAABBs()
+{
+	// The broad phase then reports everything met on the way
+	for (const SSweep& sweep : m_sweeps)
+	{
+		float radius = sweep.polygon->GetShape()->GetBoundingRadius();
+		sweep.polygon->aabb->Extend(sweep.startPosition - Vec2(radius, radius));
+		sweep.polygon->aabb->Extend(sweep.startPosition + Vec2(radius, radius));
+	}
+}
+
+void	CPhysicEngine::SolveTimeOfImpacts()
+{
+	if (m_sweeps.empty())
+	{
+		return;
+	}
+
+	// Where each swept body stops, sweeps are looked up by polygon in a sorted copy of their indices
+	struct SImpact
+	{
+		float		toi;
+		Vec2		normal; // toward other
+		CPolygon*	other;
+	};
+	typedef std::pair<const CPolygon*, size_t>	SSweepIndex;
+	TFrameVector<SImpact> impacts(m_sweeps.size(), { FLT_MAX, Vec2(), nullptr }, m_frameArena);
+	TFrameVector<SSweepIndex> sweepIndices(m_frameArena);
+	sweepIndices.reserve(m_sweeps.size());
+	for (size_t i = 0; i < m_sweeps.size(); ++i)
+	{
+		sweepIndices.push_back(SSweepIndex(m_sweeps[i].polygon.get(), i));
+	}
+	std::sort(sweepIndices.begin(), sweepIndices.end());
+
+	auto findSweep = [&](const CPolygon* polygon) -> size_t
+	{
+		auto it = std::lower_bound(sweepIndices.begin(), sweepIndices.end(), SSweepIndex(polygon, 0));
+		return (it != sweepIndices.end() && it->first == polygon) ? it->second : (size_t)-1;
+	};
+
+	// Earliest impact of each swept body, others are taken where they are now
+	for (const SPolygonPair& pair : m_pairsToCheck)
+	{
+		size_t indexA = findSweep(pair.polyA.get());
+		size_t indexB = findSweep(pair.polyB.get());
+		if (indexA == (size_t)-1 && indexB == (size_t)-1)
+		{
+			continue;
+		}
+
+		SSweep sweepA = (indexA != (size_t)-1) ? m_sweeps[indexA] : MakeStillSweep(pair.polyA);
+		SSweep sweepB = (indexB != (size_t)-1) ? m_sweeps[indexB] : MakeStillSweep(pair.polyB);
+
+		float toi;
+		Vec2 normal;
+		if (!ComputeTimeOfImpact(sweepA, sweepB, toi, normal))
+		{
+			continue;
+		}
+
+		if (indexA != (size_t)-1 && toi < impacts[indexA].toi)
+		{
+			impacts[indexA] = { toi, normal, pair.polyB.get() };
+		}
+		if (indexB != (size_t)-1 && toi < impacts[indexB].toi)
+		{
+			impacts[indexB] = { toi, normal * -1.0f, pair.polyA.get() };
+		}
+	}
+
+	size_t impactCount = 0;
+	for (size_t i = 0; i < m_sweeps.size(); ++i)
+	{
+		const SImpact& impact = impacts[i];
+		if (!impact.other)
+		{
+			continue;
+		}
+		++impactCount;
+
+		// Back to the time of impact, the rest of the step is dropped
+		CPolygon& polygon = *m_sweeps[i].polygon;
+		m_sweeps[i].GetPose(impact.toi, polygon.position, polygon.rotation);
+		polygon.UpdateTransform();
+
+		// Bounce off the other body along the impact normal
+		CPolygon& other = *impact.other;
+		float approachSpeed = (polygon.speed - other.speed) | impact.normal;
+		if (approachSpeed <= 0.0f)
+		{
+			continue;
+		}
+
+		float invMass = 1.0f / polygon.GetMass();
+		float otherInvMass = (other.density == 0.0f) ? 0.0f : 1.0f / other.GetMass();
+		float impulse = (1.0f + CCD_RESTITUTION) * approachSpeed / (invMass + otherInvMass);
+
+		polygon.speed -= impact.normal * (impulse * invMass);
+		other.speed += impact.normal * (impulse * otherInvMass);
+	}
+
+	if (gVars->bDebug)
+	{
+		gVars->pRenderer->DisplayText("Continuous collision sweeps " + std::to_string(m_sweeps.size()) + ", impacts " + std::to_string(impactCount));
+	}
+}
+
+// Pairs of a bucket go through the batch kernel by NARROW_PHASE_BATCH_SIZE
+template<typename TKernel>
+static void	CollideBucket(const TFrameVector<size_t>& bucket, const std::vector<SCachedPair*>& pairs, SCollision* collisions, uint8_t* colliding, TKernel kernel)
+{
+	for (size_t begin = 0; begin < bucket.size(); begin += NARROW_PHASE_BATCH_SIZE)
+	{
+		size_t count = Min(bucket.size() - begin, (size_t)NARROW_PHASE_BATCH_SIZE);
+		SCollision* batch[NARROW_PHASE_BATCH_SIZE];
+		SNarrowPhaseCache* caches[NARROW_PHASE_BATCH_SIZE];
+		bool batchColliding[NARROW_PHASE_BATCH_SIZE];
+		for (size_t lane = 0; lane < count; ++lane)
+		{
+			batch[lane] = &collisions[bucket[begin + lane]];
+			caches[lane] = &pairs[bucket[begin + lane]]->narrowPhase;
+		}
+
+		kernel(batch, caches, count, batchColliding);
+
+		for (size_t lane = 0; lane < count; ++lane)
+		{
+			colliding[bucket[begin + lane]] = batchColliding[lane];
+		}
+	}
 }
 
 void	CPhysicEngine::CollisionNarrowPhase()
 {
 	m_collidingPairs.clear();
 
-	for (const SPolygonPair& pair : m_pairsToCheck)
+	const std::vector<SCachedPair*>& pairs = m_pairCache.GetActivePairs();
+	TFrameVector<SCollision> collisions(pairs.size(), SCollision(), m_frameArena);
+	TFrameVector<uint8_t> colliding(pairs.size(), 0, m_frameArena);
+
+	// Circle and box pairs are bucketed to be collided by batches, the others go through Collide() right away
+	TFrameVector<size_t> circlePairs(m_frameArena), boxPairs(m_frameArena);
+	for (size_t i = 0; i < pairs.size(); ++i)
 	{
-		SCollision collision;
-		collision.polyA = pair.polyA;
-		collision.polyB = pair.polyB;
+		SCachedPair& pair = *pairs[i];
+		collisions[i].polyA = pair.polyA;
+		collisions[i].polyB = pair.polyB;
 
-		if (pair.polyA->CheckCollision(*(pair.polyB), collision))
+		switch (GetPairClass(*pair.polyA, *pair.polyB))
 		{
-			m_collidingPairs.push_back(collision);
+			case EPairClass::CircleCircle:
+				circlePairs.push_back(i);
+				break;
+			case EPairClass::BoxBox:
+				boxPairs.push_back(i);
+				break;
+			default:
+				colliding[i] = Collide(*pair.polyA, *pair.polyB, collisions[i], &pair.narrowPhase);
+				break;
+		}
+	}
+
+	CollideBucket(circlePairs, pairs, collisions.data(), colliding.data(), [](SCollision* const* batch, SNarrowPhaseCache* const* caches, size_t count, bool* batchColliding)
+	{
+		CollideCirclesBatch(batch, count, batchColliding);
+	});
+	CollideBucket(boxPairs, pairs, collisions.data(), colliding.data(), CollideBoxesBatch);
 
-			pair.polyA->speed *= -1.f;
-			pair.polyB->speed *= -1.f;
+	// Back in broad phase order
+	for (size_t i = 0; i < pairs.size(); ++i)
+	{
+		SCachedPair& pair = *pairs[i];
+		if (colliding[i])
+		{
+			m_pairCache.UpdateManifold(pair, collisions[i]);
+			m_collidingPairs.push_back(collisions[i]);
+		}
+		else
+		{
+			m_pairCache.ClearManifold(pair);
 		}
 	}
-}
\ No newline at end of file
+}
+
+void	CPhysicEngine::SolveContacts(float deltaTime, float restitution)
+{
+	CTimer timer;
+	timer.Start();
+	m_contactSolver.Solve(m_pairCache.GetActivePairs(), deltaTime, restitution);
+	timer.Stop();
+	if (gVars->bDebug)
+	{
+		gVars->pRenderer->DisplayText("Contact solver duration " + std::to_string(timer.GetDuration() * 1000.0f) + " ms, constraints : " + std::to_string(m_contactSolver.GetConstraintCount()) + ", colors : " + std::to_string(m_contactSolver.GetColorCount()));
+	}
+}
@@ -2,10 +2,14 @@
 #define _PHYSIC_ENGINE_H_
 
 #include <vector>
-#include <unordered_map>
 #include "Maths.h"
+#include "FrameArena.h"
 #include "Polygon.h"
 #include "Collision.h"
+#include "PairCache.h"
+#include "ContactSolver.h"
+#include "TimeOfImpact.h"
+#include "TrajectoryRecorder.h"
 
 class IBroadPhase;
 
@@ -22,6 +26,14 @@ public:
 
 	void	Step(float deltaTime);
 
+	CTrajectoryRecorder&	GetTrajectoryRecorder();
+
+	// Transient data of the current step, everything is dropped when the next one starts
+	CFrameArena&			GetFrameArena();
+
+	// Also used by the world queries, see CWorld::QueryAABB
+	const IBroadPhase*		GetBroadPhase() const;
+
 	template<typename TFunctor>
 	void	ForEachCollision(TFunctor functor)
 	{
@@ -34,14 +46,33 @@ public:
 private:
 	void							CollisionBroadPhase();
 	void							CollisionNarrowPhase();
+	void							SolveContacts(float deltaTime, float restitution);
+
+	// Continuous collision of bullets and bodies moving more than their size in a step
+	bool							NeedsContinuousCollision(const SSweep& sweep) const;
+	void							ExtendSweptAABBs();
+	void							SolveTimeOfImpacts();
 
 	bool							m_active = true;
 
+	CFrameArena						m_frameArena;
+
 	// Collision detection
-	IBroadPhase*					m_broadPhase;
+	IBroadPhase*					m_broadPhase = nullptr;
 	std::vector<SPolygonPair>		m_pairsToCheck;
 	std::vector<SCollision>			m_collidingPairs;
 
+	// Narrow phase data and manifolds of the pairs found by the broad phase, kept while the pair is reported
+	CPairCache						m_pairCache;
+
+	// Contact impulses of the colliding pairs
+	CContactSolver					m_contactSolver;
+
+	// Motions of the step that need continuous collision
+	std::vector<SSweep>				m_sweeps;
+
+	CTrajectoryRecorder				m_trajectoryRecorder;
+
 };
 
 #endif
\ No newline at end of file
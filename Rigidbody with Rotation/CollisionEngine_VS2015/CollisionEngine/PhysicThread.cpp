@@ -0,0 +1,139 @@
+#include "PhysicThread.h"
+
+#include <chrono>
+
+#include "GlobalVariables.h"
+#include "PhysicEngine.h"
+#include "Renderer.h"
+#include "World.h"
+#include "Timer.h"
+
+CPhysicThread::CPhysicThread()
+	: m_running(false), m_lastTickDuration(0.0f)
+{
+}
+
+CPhysicThread::~CPhysicThread()
+{
+	Stop();
+}
+
+void	CPhysicThread::Start()
+{
+	if (m_running)
+	{
+		return;
+	}
+
+	m_running = true;
+	m_thread = std::thread(&CPhysicThread::Run, this);
+}
+
+void	CPhysicThread::Stop()
+{
+	if (!m_running)
+	{
+		return;
+	}
+
+	m_running = false;
+	m_thread.join();
+}
+
+bool	CPhysicThread::IsRunning() const
+{
+	return m_running;
+}
+
+void	CPhysicThread::Tick(float deltaTime)
+{
+	SRenderSnapshot& snapshot = m_snapshots.GetWriteBuffer();
+	snapshot.Clear();
+
+	{
+		std::lock_guard<std::mutex> lock(m_inputMutex);
+		m_tickInput = m_pendingInput;
+	}
+
+	CTimer timer;
+	{
+		std::lock_guard<std::mutex> lock(m_worldMutex);
+
+		// Debug lines and texts of this thread go to the snapshot
+		gVars->pRenderer->SetThreadDrawTarget(&snapshot);
+
+		timer.Start();
+		gVars->pPhysicEngine->Step(deltaTime);
+		if (gVars->pWorld)
+		{
+			gVars->pWorld->Update(deltaTime);
+		}
+		timer.Stop();
+
+		if (gVars->pWorld)
+		{
+			gVars->pWorld->FillSnapshot(snapshot);
+		}
+
+		gVars->pRenderer->SetThreadDrawTarget(nullptr);
+	}
+
+	snapshot.tick = m_tickCount++;
+	m_lastTickDuration = timer.GetDuration();
+	m_snapshots.Publish();
+}
+
+std::mutex&	CPhysicThread::GetWorldMutex()
+{
+	return m_worldMutex;
+}
+
+void	CPhysicThread::SetInput(const SInputState& input)
+{
+	std::lock_guard<std::mutex> lock(m_inputMutex);
+	m_pendingInput = input;
+}
+
+const SInputState&	CPhysicThread::GetInput() const
+{
+	return m_tickInput;
+}
+
+bool	CPhysicThread::AcquireSnapshot()
+{
+	return m_snapshots.Acquire();
+}
+
+const SRenderSnapshot&	CPhysicThread::GetSnapshot() const
+{
+	return m_snapshots.GetReadBuffer();
+}
+
+float	CPhysicThread::GetLastTickDuration() const
+{
+	return m_lastTickDuration;
+}
+
+void	CPhysicThread::Run()
+{
+	typedef std::chrono::steady_clock Clock;
+
+	const float tickTime = 1.0f / PHYSIC_TICK_RATE;
+	const Clock::duration tickDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(tickTime));
+
+	Clock::time_point nextTick = Clock::now();
+	while (m_running)
+	{
+		Tick(tickTime);
+
+		nextTick += tickDuration;
+		Clock::time_point now = Clock::now();
+		if (now > nextTick + tickDuration * PHYSIC_MAX_LATE_TICKS)
+		{
+			// Too slow to keep up, slow the simulation down rather than spiraling
+			nextTick = now;
+		}
+
+		std::this_thread::sleep_until(nextTick);
+	}
+}
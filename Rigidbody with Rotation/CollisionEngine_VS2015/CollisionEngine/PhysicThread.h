@@ -0,0 +1,66 @@
+#ifndef _PHYSIC_THREAD_H_
+#define _PHYSIC_THREAD_H_
+
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+#include "InputState.h"
+#include "RenderSnapshot.h"
+#include "TripleBuffer.h"
+
+// Fixed rate of the physic thread, in ticks per second
+#define PHYSIC_TICK_RATE		60.0f
+// Late ticks are dropped past this many instead of being caught up
+#define PHYSIC_MAX_LATE_TICKS	4
+
+// Steps the physic engine and the world behaviors, then publishes a SRenderSnapshot
+// Runs on its own thread at PHYSIC_TICK_RATE once started, otherwise the renderer ticks it every frame
+class CPhysicThread
+{
+public:
+	CPhysicThread();
+	~CPhysicThread();
+
+	CPhysicThread(const CPhysicThread&) = delete;
+	CPhysicThread& operator=(const CPhysicThread&) = delete;
+
+	void	Start();
+	void	Stop();
+	bool	IsRunning() const;
+
+	// Step and publish, only call it directly while the thread is not running
+	void	Tick(float deltaTime);
+
+	// Held during each tick, hold it to load scenes or edit the world from another thread
+	std::mutex&	GetWorldMutex();
+
+	// Main thread side, taken by the next tick
+	void				SetInput(const SInputState& input);
+	// Input of the tick in progress, only for the physic thread (behaviors)
+	const SInputState&	GetInput() const;
+
+	// Render side, switch to the latest snapshot (see CTripleBuffer)
+	bool					AcquireSnapshot();
+	const SRenderSnapshot&	GetSnapshot() const;
+
+	// Physic and behaviors update of the last tick, in seconds
+	float	GetLastTickDuration() const;
+
+private:
+	void	Run();
+
+	std::thread			m_thread;
+	std::atomic<bool>	m_running;
+	std::mutex			m_worldMutex;
+
+	std::mutex			m_inputMutex;
+	SInputState			m_pendingInput; // under m_inputMutex
+	SInputState			m_tickInput;
+
+	CTripleBuffer<SRenderSnapshot>	m_snapshots;
+	size_t							m_tickCount = 0;
+	std::atomic<float>				m_lastTickDuration;
+};
+
+#endif
@@ -1,56 +1,72 @@
 #include "Polygon.h"
 #include <GL/glu.h>
 
-#include "InertiaTensor.h"
-
 #include "PhysicEngine.h"
 #include "GlobalVariables.h"
 #include "Renderer.h"
 #include "Collision.h"
+#include "Geometry.h"
 
 CPolygon::CPolygon(size_t index)
-	: m_vertexBufferId(0), m_index(index), density(0.1f)
+	: m_index(index), density(0.1f)
 {
 	aabb = new AABB();
 }
 
 CPolygon::~CPolygon()
 {
-	DestroyBuffers();
 }
 
 void CPolygon::Build()
 {
-	m_lines.clear();
+	if (points.empty())
+	{
+		return;
+	}
 
-	ComputeArea();
-	RecenterOnCenterOfMass();
-	ComputeLocalInertiaTensor();
+	SetShape(std::make_shared<CShape>(points));
+	std::vector<Vec2>().swap(points);
+}
 
-	CreateBuffers();
-	BuildLines();
+void CPolygon::SetShape(CShapePtr shape)
+{
+	m_shape = shape;
+	position += m_shape->GetCentroid();
+
+	m_children.clear();
+	for (const CShapePtr& childShape : m_shape->GetChildren())
+	{
+		// -1 cannot be in the index
+		std::unique_ptr<CPolygon> child(new CPolygon(-1));
+		child->m_shape = childShape;
+		m_children.push_back(std::move(child));
+	}
 }
 
-void CPolygon::Draw()
+CShapePtr CPolygon::GetShape() const
 {
-	UpdateAABB();
+	return m_shape;
+}
 
-	glColor3f(0.7f, 0.7f, 0.7f);
+const TShapeArray<Vec2>& CPolygon::GetPoints() const
+{
+	static const TShapeArray<Vec2> noPoints;
+	return m_shape ? m_shape->GetPoints() : noPoints;
+}
 
-	// Set transforms (qssuming model view mode is set)
-	float transfMat[16] = {	rotation.X.x, rotation.X.y, 0.0f, 0.0f,
-							rotation.Y.x, rotation.Y.y, 0.0f, 0.0f,
-							0.0f, 0.0f, 0.0f, 1.0f,
-							position.x, position.y, -1.0f, 1.0f };
-	glPushMatrix();
-	glMultMatrixf(transfMat);
+bool CPolygon::IsCircle() const
+{
+	return m_shape && m_shape->GetType() == EShapeType::Circle;
+}
 
-	// Draw vertices
-	BindBuffers();
-	glDrawArrays(GL_LINE_LOOP, 0, points.size());
-	glDisableClientState(GL_VERTEX_ARRAY);
+bool CPolygon::IsCompound() const
+{
+	return !m_children.empty();
+}
 
-	glPopMatrix();
+const CPolygon& CPolygon::GetChild(size_t index) const
+{
+	return *m_children[index];
 }
 
 size_t	CPolygon::GetIndex() const
@@ -60,7 +76,7 @@ size_t	CPolygon::GetIndex() const
 
 float	CPolygon::GetArea() const
 {
-	return fabsf(m_signedArea);
+	return m_shape ? m_shape->GetArea() : 0.0f;
 }
 
 Vec2	CPolygon::TransformPoint(const Vec2& point) const
@@ -117,83 +133,18 @@ void	CPolygon::DrawCenterOfGravity()
 	}
 }*/
 
-CPolygon* CPolygon::MinkowskiDiff(const CPolygon& otherPoly) const
-{
-	// -1 cannot be in the index
-	CPolygon* poly = new CPolygon(-1);
-	for (unsigned int i = 0; i < points.size(); i++)
-	{
-		for (unsigned int j = 0; j < otherPoly.points.size(); j++)
-			poly->points.push_back(otherPoly.TransformPoint(otherPoly.points[j]) - TransformPoint(points[i]));
-	}
-	poly->ConvexHull();
-	return poly;
-}
-
-int CPolygon::Orientation(Vec2 pivot, Vec2 externalPoint, Vec2 anyOther)
-{
-	float val = (externalPoint.y - pivot.y) * (anyOther.x - externalPoint.x) - (externalPoint.x - pivot.x) * (anyOther.y - externalPoint.y);
-
-	// Points are clockwise
-	if (val > 0.f)
-		return 1;
-
-	// Points are counterclockwise
-	else if (val < 0.f)
-		return 2;
-
-	// Points are colinear
-	else
-		return 0;
-}
-
 void CPolygon::ConvexHull()
 {
-	//	At least three points needed
-	if (points.size() < 3)
-		return;
-
-	std::vector<Vec2> hull;
-
-	int leftPoint = 0;
-
-	// Find out the leftmost point
-	for (unsigned int i = 1; i < points.size(); i++)
-	{
-		if (points[i].x < points[leftPoint].x || (points[i].x == points[leftPoint].x && points[i].y < points[leftPoint].y))
-			leftPoint = i;
-	}
-
-	int pivot = leftPoint;
-	int externalPoint = 0;
-
-	do
-	{
-		hull.push_back(points[pivot]);
-
-		externalPoint = (pivot + 1) % points.size();
-
-		for (unsigned int i = 0; i < points.size(); i++)
-		{
-			// If counterclockwise
-			if (Orientation(points[pivot], points[i], points[externalPoint]) == 2)
-				externalPoint = i;
-		}
-		pivot = externalPoint;
-
-	} while (pivot != leftPoint);
-
-	points = hull;
-	hull.clear();
+	ComputeConvexHull(points);
 }
 
-int CPolygon::SupportPoint(Vec2& direction)
+static int	SupportPoint(const Vec2* points, size_t count, const Vec2& direction)
 {
 	int index = 0;
 	float maxVal = points[index] | direction;
 	float currentVal;
 
-	for (int i = 1; i < points.size(); i++)
+	for (int i = 1; i < (int)count; i++)
 	{
 		currentVal = points[i] | direction;
 		if (maxVal < currentVal)
@@ -205,18 +156,26 @@ int CPolygon::SupportPoint(Vec2& direction)
 	return index;
 }
 
-bool CPolygon::GJK(Vec2& impact, Vec2& normal, float distance)
+// GJK on the points of a Minkowski difference, the origin is inside when the shapes overlap
+// searchDirection is optional : used as first search direction if not zero, then set to the last one
+static bool	GJK(const Vec2* points, size_t count, Vec2& impact, Vec2& normal, float distance, Vec2* searchDirection)
 {
 	const Vec2 origin = Vec2::Zero();
 	Simplex simplex = Simplex();
-	simplex.AddPoint(points[0]);
 	int prevSupportPointIndex = -1;
 
 	Vec2 point;
 	Vec2 direction;
-	int index;
+	int index = 0;
+
+	// Warm start from last frame search direction
+	if (searchDirection && searchDirection->GetSqrLength() > 0.0f)
+	{
+		index = SupportPoint(points, count, *searchDirection);
+	}
+	simplex.AddPoint(points[index]);
 
-	int maxLimit = points.size() * points.size();
+	int maxLimit = (int)(count * count);
 	int limitCount = 0;
 
 	do
@@ -225,10 +184,10 @@ bool CPolygon::GJK(Vec2& impact, Vec2& normal, float distance)
 
 		if (simplex.count == 3)
 		{
-			gVars->pRenderer->DrawLine(point, point + Vec2(0.5f, 0.5f), 0.1f, 0.7f, 0.7f);
-			gVars->pRenderer->DrawLine(point, point + Vec2(-0.5f, -0.5f), 0.1f, 0.7f, 0.7f);
-			gVars->pRenderer->DrawLine(point, point + Vec2(0.5f, -0.5f), 0.1f, 0.7f, 0.7f);
-			gVars->pRenderer->DrawLine(point, point + Vec2(-0.5f, 0.5f), 0.1f, 0.7f, 0.7f);
+			gVars->pRenderer->DrawLine(point, point + Vec2(0.5f, 0.5f), 0.1f, 0.7f, 0.7f, EDebugCategory::Simplex);
+			gVars->pRenderer->DrawLine(point, point + Vec2(-0.5f, -0.5f), 0.1f, 0.7f, 0.7f, EDebugCategory::Simplex);
+			gVars->pRenderer->DrawLine(point, point + Vec2(0.5f, -0.5f), 0.1f, 0.7f, 0.7f, EDebugCategory::Simplex);
+			gVars->pRenderer->DrawLine(point, point + Vec2(-0.5f, 0.5f), 0.1f, 0.7f, 0.7f, EDebugCategory::Simplex);
 		}
 
 		if (simplex.ComparePoints(origin, point))
@@ -236,7 +195,11 @@ bool CPolygon::GJK(Vec2& impact, Vec2& normal, float distance)
 			impact = points[index];
 			normal = simplex.ComputeNormal();
 			distance = normal.GetLength();
-			gVars->pRenderer->DrawLine(normal, Vec2(0.f, 0.f), 0.7f, 0.6f, 0.1f);
+			gVars->pRenderer->DrawLine(normal, Vec2(0.f, 0.f), 0.7f, 0.6f, 0.1f, EDebugCategory::Simplex);
+			if (searchDirection)
+			{
+				*searchDirection = direction;
+			}
 			return true;
 		}
 
@@ -244,21 +207,27 @@ bool CPolygon::GJK(Vec2& impact, Vec2& normal, float distance)
 
 		direction = origin - point;
 
-		gVars->pRenderer->DrawLine(point, direction, 0.8f, 0.1f, 0.1f);
+		gVars->pRenderer->DrawLine(point, direction, 0.8f, 0.1f, 0.1f, EDebugCategory::Simplex);
 
 
-		index = SupportPoint(direction);
+		index = SupportPoint(points, count, direction);
 		simplex.AddPoint(points[index]);
 
 		simplex.Draw();
 
-		gVars->pRenderer->DrawLine(Vec2(0.f, 0.f), Vec2(0.5f, 0.5f), 0.6f, 0.5f, 0.1f);
-		gVars->pRenderer->DrawLine(Vec2(0.f, 0.f), Vec2(-0.5f, -0.5f), 0.6f, 0.5f, 0.1f);
-		gVars->pRenderer->DrawLine(Vec2(0.f, 0.f), Vec2(0.5f, -0.5f), 0.6f, 0.5f, 0.1f);
-		gVars->pRenderer->DrawLine(Vec2(0.f, 0.f), Vec2(-0.5f, 0.5f), 0.6f, 0.5f, 0.1f);
+		gVars->pRenderer->DrawLine(Vec2(0.f, 0.f), Vec2(0.5f, 0.5f), 0.6f, 0.5f, 0.1f, EDebugCategory::Simplex);
+		gVars->pRenderer->DrawLine(Vec2(0.f, 0.f), Vec2(-0.5f, -0.5f), 0.6f, 0.5f, 0.1f, EDebugCategory::Simplex);
+		gVars->pRenderer->DrawLine(Vec2(0.f, 0.f), Vec2(0.5f, -0.5f), 0.6f, 0.5f, 0.1f, EDebugCategory::Simplex);
+		gVars->pRenderer->DrawLine(Vec2(0.f, 0.f), Vec2(-0.5f, 0.5f), 0.6f, 0.5f, 0.1f, EDebugCategory::Simplex);
 
 		if (index == prevSupportPointIndex)
+		{
+			if (searchDirection)
+			{
+				*searchDirection = direction;
+			}
 			return false;
+		}
 
 		prevSupportPointIndex = index;
 		limitCount++;
@@ -273,7 +242,29 @@ bool	CPolygon::IsPointInside(const Vec2& point) const
 {
 	float maxDist = -FLT_MAX;
 
-	for (const Line& line : m_lines)
+	if (!m_shape)
+	{
+		return false;
+	}
+
+	if (IsCircle())
+	{
+		return (point - position).GetSqrLength() <= m_shape->GetRadius() * m_shape->GetRadius();
+	}
+
+	if (IsCompound())
+	{
+		for (const std::unique_ptr<CPolygon>& child : m_children)
+		{
+			if (child->IsPointInside(point))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	for (const Line& line : m_shape->GetLines())
 	{
 		Line globalLine = line.Transform(rotation, position);
 		float pointDist = globalLine.GetPointDist(point);
@@ -291,7 +282,18 @@ bool	CPolygon::IsLineIntersectingPolygon(const Line& line, Vec2& colPoint, float
 	float lastDist = 0.0f;
 	bool intersecting = false;
 
-	for (const Vec2& point : points)
+	if (IsCircle())
+	{
+		float dist = line.GetPointDist(position) - m_shape->GetRadius();
+		if (dist <= 0.0f)
+		{
+			colDist = -dist;
+			colPoint = position - line.GetNormal() * m_shape->GetRadius();
+		}
+		return (dist <= 0.0f);
+	}
+
+	for (const Vec2& point : GetPoints())
 	{
 		Vec2 globalPoint = TransformPoint(point);
 		float dist = line.GetPointDist(globalPoint);
@@ -313,26 +315,50 @@ bool	CPolygon::IsLineIntersectingPolygon(const Line& line, Vec2& colPoint, float
 	return (minDist <= 0.0f);
 }
 
-bool	CPolygon::CheckCollision(const CPolygon& poly, SCollision& collision) const
+bool	CPolygon::CheckCollision(const CPolygon& poly, SCollision& collision, Vec2* searchDirection) const
 {
-	CPolygon* polyResult = MinkowskiDiff(poly);
+	// Transient, the arena is reset by the next step
+	const TShapeArray<Vec2>& worldPoints = GetWorldPoints();
+	const TShapeArray<Vec2>& otherWorldPoints = poly.GetWorldPoints();
+	TFrameVector<Vec2> difference(worldPoints.size() + otherWorldPoints.size(), Vec2(), gVars->pPhysicEngine->GetFrameArena());
+	size_t count = MinkowskiDifference(otherWorldPoints.data(), otherWorldPoints.size(), worldPoints.data(), worldPoints.size(), difference.data());
 
 	//	Can be drawn in debug mode
-	for (int i = 0; i < polyResult->points.size() && aabb->bIsDisplayed; i++)
+	for (size_t i = 0; i < count && aabb->bIsDisplayed; i++)
 	{
-		if (i < polyResult->points.size() - 1)
-			gVars->pRenderer->DrawLine(polyResult->points[i], polyResult->points[i + 1], 0.7f, 0.3f, 0.1f);
+		gVars->pRenderer->DrawLine(difference[i], difference[(i + 1) % count], 0.7f, 0.3f, 0.1f, EDebugCategory::Minkowski);
+	}
 
-		else
-			gVars->pRenderer->DrawLine(polyResult->points[i], polyResult->points[0], 0.7f, 0.3f, 0.1f);
+	if (count == 0 || !GJK(difference.data(), count, collision.point, collision.normal, collision.distance, searchDirection))
+	{
+		return false;
 	}
 
-	bool bGJKResult = polyResult->GJK(collision.point, collision.normal, collision.distance);// colPoint, colNormal, colDist);
+	// The whole difference is known, its edge closest to the origin is where EPA would converge
+	// It is counterclockwise, outward normals are on the right of the edges
+	float penetration = FLT_MAX;
+	Vec2 outwardNormal;
+	for (size_t i = 0; i < count; ++i)
+	{
+		Vec2 edge = difference[(i + 1) % count] - difference[i];
+		if (edge.GetSqrLength() == 0.0f)
+		{
+			continue;
+		}
 
-	delete polyResult;
+		Vec2 normal = edge.GetNormal().Normalized() * -1.0f;
+		float distance = normal | difference[i];
+		if (distance < penetration)
+		{
+			penetration = distance;
+			outwardNormal = normal;
+		}
+	}
 
-	return bGJKResult;
-	//return false;
+	// Pushing the other polygon along -outwardNormal separates them
+	collision.normal = outwardNormal * -1.0f;
+	collision.distance = Max(penetration, 0.0f);
+	return true;
 }
 
 AABB*	CPolygon::GetOwnAABB()
@@ -340,131 +366,61 @@ AABB*	CPolygon::GetOwnAABB()
 	return aabb;
 }
 
-void CPolygon::UpdateAABB()
+void CPolygon::UpdateTransform()
 {
-	aabb->Center(position);
-	for (const Vec2& point : points)
+	const TShapeArray<Vec2>& localPoints = GetPoints();
+	m_worldPoints.resize(localPoints.size());
+	for (size_t i = 0; i < localPoints.size(); ++i)
 	{
-		aabb->Extend(TransformPoint(point));
+		m_worldPoints[i] = TransformPoint(localPoints[i]);
 	}
 
-	if (aabb->bIsDisplayed)
-		aabb->RenderBoundingBox();
-}
-
-float CPolygon::GetMass() const
-{
-	return density * GetArea();
-}
-
-float CPolygon::GetInertiaTensor() const
-{
-	return m_localInertiaTensor * GetMass();
-}
-
-Vec2 CPolygon::GetPointVelocity(const Vec2& point) const
-{
-	return speed + (point - position).GetNormal() * angularVelocity;
-}
-
-void CPolygon::CreateBuffers()
-{
-	DestroyBuffers();
+	UpdateAABB();
 
-	float* vertices = new float[3 * points.size()];
-	for (size_t i = 0; i < points.size(); ++i)
+	for (const std::unique_ptr<CPolygon>& child : m_children)
 	{
-		vertices[3 * i] = points[i].x;
-		vertices[3 * i + 1] = points[i].y;
-		vertices[3 * i + 2] = 0.0f;
+		child->position = TransformPoint(child->m_shape->GetCentroid());
+		child->rotation = rotation;
+		child->UpdateTransform();
 	}
-
-	glGenBuffers(1, &m_vertexBufferId);
-
-	glBindBuffer(GL_ARRAY_BUFFER, m_vertexBufferId);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 3 * points.size(), vertices, GL_STATIC_DRAW);
-
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-	delete[] vertices;
 }
 
-void CPolygon::BindBuffers()
+const TShapeArray<Vec2>&	CPolygon::GetWorldPoints() const
 {
-	if (m_vertexBufferId != 0)
-	{
-		glBindBuffer(GL_ARRAY_BUFFER, m_vertexBufferId);
-
-		glEnableClientState(GL_VERTEX_ARRAY);
-		glVertexPointer(3, GL_FLOAT, 0, (void*)0);
-	}
+	return m_worldPoints;
 }
 
-
-void CPolygon::DestroyBuffers()
+void CPolygon::UpdateAABB()
 {
-	if (m_vertexBufferId != 0)
+	aabb->Center(position);
+	if (IsCircle())
 	{
-		glDeleteBuffers(1, &m_vertexBufferId);
-		m_vertexBufferId = 0;
+		Vec2 extent(m_shape->GetRadius(), m_shape->GetRadius());
+		aabb->min = position - extent;
+		aabb->max = position + extent;
 	}
-}
-
-void CPolygon::BuildLines()
-{
-	for (size_t index = 0; index < points.size(); ++index)
+	else
 	{
-		const Vec2& pointA = points[index];
-		const Vec2& pointB = points[(index + 1) % points.size()];
-
-		Vec2 lineDir = (pointA - pointB).Normalized();
-
-		m_lines.push_back(Line(pointB, lineDir, (pointA - pointB).GetLength()));
+		for (const Vec2& point : m_worldPoints)
+		{
+			aabb->Extend(point);
+		}
 	}
 }
 
-void CPolygon::ComputeArea()
+float CPolygon::GetMass() const
 {
-	m_signedArea = 0.0f;
-	for (size_t index = 0; index < points.size(); ++index)
-	{
-		const Vec2& pointA = points[index];
-		const Vec2& pointB = points[(index + 1) % points.size()];
-		m_signedArea += pointA.x * pointB.y - pointB.x * pointA.y;
-	}
-	m_signedArea *= 0.5f;
+	return density * GetArea();
 }
 
-void CPolygon::RecenterOnCenterOfMass()
+float CPolygon::GetInertiaTensor() const
 {
-	Vec2 centroid;
-	for (size_t index = 0; index < points.size(); ++index)
-	{
-		const Vec2& pointA = points[index];
-		const Vec2& pointB = points[(index + 1) % points.size()];
-		float factor = pointA.x * pointB.y - pointB.x * pointA.y;
-		centroid.x += (pointA.x + pointB.x) * factor;
-		centroid.y += (pointA.y + pointB.y) * factor;
-	}
-	centroid /= 6.0f * m_signedArea;
-
-	for (Vec2& point : points)
-	{
-		point -= centroid;
-	}
-	position += centroid;
+	return m_shape ? m_shape->GetLocalInertiaTensor() * GetMass() : 0.0f;
 }
 
-void CPolygon::ComputeLocalInertiaTensor()
+Vec2 CPolygon::GetPointVelocity(const Vec2& point) const
 {
-	m_localInertiaTensor = 0.0f;
-	for (size_t i = 0; i + 1 < points.size(); ++i)
-	{
-		const Vec2& pointA = points[i];
-		const Vec2& pointB = points[i + 1];
-
-		m_localInertiaTensor += ComputeInertiaTensor_Triangle(Vec2(), pointA, pointB);
-	}
+	return speed + (point - position).GetNormal() * angularVelocity;
 }
 
 bool operator < (const CPolygonPtr& poly, const CPolygonPtr& otherPoly)
@@ -2,13 +2,32 @@
 #define _POLYGON_H_
 
 #include <GL/glew.h>
+#include <stdint.h>
 #include <vector>
 #include <memory>
 
 
 #include "Maths.h"
+#include "Shape.h"
 
+// Which polygons may collide, checked by the broad phase before a pair is emitted
+// Polygons of the same non zero group always collide if it is positive and never if it is negative,
+// otherwise each category must be in the mask of the other
+struct SCollisionFilter
+{
+	uint16_t	category = 0x0001;
+	uint16_t	mask = 0xFFFF;
+	int16_t		group = 0;
+};
 
+inline bool	ShouldCollide(const SCollisionFilter& filterA, const SCollisionFilter& filterB)
+{
+	if (filterA.group != 0 && filterA.group == filterB.group)
+	{
+		return filterA.group > 0;
+	}
+	return (filterA.category & filterB.mask) != 0 && (filterB.category & filterA.mask) != 0;
+}
 
 
 class CPolygon
@@ -22,11 +41,37 @@ public:
 
 	Vec2				position;
 	Mat2				rotation;
-	std::vector<Vec2>	points;
+	std::vector<Vec2>	points; // local points used by Build(), released once the shape is built
 	AABB*				aabb;
 
+	// Build a shape of its own from points
 	void				Build();
-	void				Draw();
+	// Share an already built shape, position is moved like Build() would
+	void				SetShape(CShapePtr shape);
+	CShapePtr			GetShape() const;
+	const TShapeArray<Vec2>&	GetPoints() const; // of the shape, empty until built
+	bool				IsCircle() const;
+
+	// Concave polygons collide through one child polygon per convex piece of their shape, moved along by UpdateTransform()
+	bool				IsCompound() const;
+	const CPolygon&		GetChild(size_t index) const;
+
+	// functor(const CPolygon&) for the children of a compound, for the polygon itself otherwise
+	template<typename TFunctor>
+	void				ForEachConvexPart(TFunctor functor) const
+	{
+		if (m_children.empty())
+		{
+			functor(*this);
+			return;
+		}
+
+		for (const std::unique_ptr<CPolygon>& child : m_children)
+		{
+			functor(*child);
+		}
+	}
+
 	size_t				GetIndex() const;
 
 	float				GetArea() const;
@@ -41,26 +86,21 @@ public:
 	//Vec2				GetCenterOfGravity();
 	//void				DrawCenterOfGravity();
 
-	// Minkowski's Algorithm
-	CPolygon*			MinkowskiDiff(const CPolygon& otherPoly) const;
-	int					Orientation(Vec2 pivot, Vec2 externalPoint, Vec2 anyOther);
-	//	Jarvis' Algorithm
+	//	Monotone chain, see ComputeConvexHull
 	void				ConvexHull();
 
-	//	The Polygon finds its own Support point according to the given direction by returning its points' index
-	int					SupportPoint(Vec2& direction);
-
-	bool				GJK(Vec2& impact, Vec2& normal, float distance);
-
-
 	// If line intersect polygon, colDist is the penetration distance, and colPoint most penetrating point of poly inside the line
 	bool				IsLineIntersectingPolygon(const Line& line, Vec2& colPoint, float& colDist) const;
-	bool				CheckCollision(const CPolygon& poly, struct SCollision& collision) const;
+	// On collision, normal goes from this to poly and distance is the penetration depth
+	bool				CheckCollision(const CPolygon& poly, struct SCollision& collision, Vec2* searchDirection = nullptr) const;
 
 
 
 	AABB*				GetOwnAABB();
-	void				UpdateAABB();
+
+	// World space points and AABB, refreshed by the physic step for collision detection and rendering
+	void				UpdateTransform();
+	const TShapeArray<Vec2>&	GetWorldPoints() const;
 
 	float				GetMass() const;
 	float				GetInertiaTensor() const;
@@ -76,27 +116,21 @@ public:
 
 	float				invMass = 1.f;
 
+	// Always checked for time of impact, for small fast bodies (see CPhysicEngine::SolveTimeOfImpacts)
+	bool				bullet = false;
 
-private:
-	void				CreateBuffers();
-	void				BindBuffers();
-	void				DestroyBuffers();
+	SCollisionFilter	filter;
 
-	void				BuildLines();
 
-	void				ComputeArea();
-	void				RecenterOnCenterOfMass(); // Area must be computed
-	void				ComputeLocalInertiaTensor(); // Must be centered on center of mass
+private:
+	void				UpdateAABB();
 
-	GLuint				m_vertexBufferId;
 	size_t				m_index;
 
-	std::vector<Line>	m_lines;
-
-	float				m_signedArea;
+	CShapePtr			m_shape;
+	TShapeArray<Vec2>	m_worldPoints;
 
-	// Physics
-	float				m_localInertiaTensor; // don't consider mass
+	std::vector<std::unique_ptr<CPolygon>>	m_children;
 };
 
 typedef std::shared_ptr<CPolygon>	CPolygonPtr;
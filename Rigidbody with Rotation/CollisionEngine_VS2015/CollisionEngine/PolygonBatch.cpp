@@ -0,0 +1,58 @@
+#include "PolygonBatch.h"
+
+void	CPolygonBatch::Clear()
+{
+	m_vertices.clear();
+	m_outlineCount = 0;
+	m_indexCount = 0;
+	m_topologyHash = POLYGON_BATCH_HASH_SEED;
+}
+
+void	CPolygonBatch::AddOutline(const Vec2* points, size_t count)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	uint32_t base = (uint32_t)m_vertices.size();
+	m_vertices.insert(m_vertices.end(), points, points + count);
+
+	if (m_outlineCount >= m_outlineSizes.size() || m_outlineSizes[m_outlineCount] != count)
+	{
+		// Topology changed from here, rebuild the following indices
+		m_outlineSizes.resize(m_outlineCount);
+		m_outlineSizes.push_back(count);
+		m_indices.resize(m_indexCount);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			m_indices.push_back(base + (uint32_t)i);
+			m_indices.push_back(base + (uint32_t)((i + 1) % count));
+		}
+	}
+	m_topologyHash = (m_topologyHash ^ (uint64_t)count) * POLYGON_BATCH_HASH_PRIME;
+
+	++m_outlineCount;
+	m_indexCount += 2 * count;
+}
+
+const std::vector<Vec2>&	CPolygonBatch::GetVertices() const
+{
+	return m_vertices;
+}
+
+const uint32_t*	CPolygonBatch::GetIndices() const
+{
+	return m_indices.data();
+}
+
+size_t	CPolygonBatch::GetIndexCount() const
+{
+	return m_indexCount;
+}
+
+uint64_t	CPolygonBatch::GetTopologyHash() const
+{
+	return m_topologyHash;
+}
@@ -0,0 +1,40 @@
+#ifndef _POLYGON_BATCH_H_
+#define _POLYGON_BATCH_H_
+
+#include <stdint.h>
+#include <vector>
+
+#include "Maths.h"
+
+// FNV-1a over the outline sizes of a frame, see GetTopologyHash
+#define POLYGON_BATCH_HASH_SEED		14695981039346656037ull
+#define POLYGON_BATCH_HASH_PRIME	1099511628211ull
+
+// World space outlines of every polygon of a frame, drawn as indexed GL_LINES
+// No GL calls here, see CBatchRenderer
+class CPolygonBatch
+{
+public:
+	// Start a new frame, indices are kept while outlines keep the same vertex counts
+	void	Clear();
+	void	AddOutline(const Vec2* points, size_t count);
+
+	const std::vector<Vec2>&	GetVertices() const;
+	const uint32_t*				GetIndices() const;
+	size_t						GetIndexCount() const;
+
+	// Indices only depend on the outline sizes, batches with the same hash and index count have the same indices
+	// Each snapshot owns a batch, so the renderer compares contents rather than batch identity
+	uint64_t					GetTopologyHash() const;
+
+private:
+	std::vector<Vec2>		m_vertices;
+	std::vector<uint32_t>	m_indices;
+	std::vector<size_t>		m_outlineSizes;
+
+	size_t	m_outlineCount = 0;
+	size_t	m_indexCount = 0;
+	uint64_t	m_topologyHash = POLYGON_BATCH_HASH_SEED;
+};
+
+#endif
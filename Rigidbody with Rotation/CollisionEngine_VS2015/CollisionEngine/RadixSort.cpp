@@ -0,0 +1,71 @@
+#include "RadixSort.h"
+
+#include <algorithm>
+
+#include "GlobalVariables.h"
+#include "ThreadPool.h"
+
+void	CRadixSorter::Sort(std::vector<uint32_t>& keys, std::vector<uint32_t>& values, size_t chunkCount)
+{
+	size_t count = keys.size();
+	if (count < 2)
+	{
+		return;
+	}
+
+	chunkCount = std::max<size_t>(1, std::min(chunkCount, count));
+	size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+	m_scratchKeys.resize(count);
+	m_scratchValues.resize(count);
+	m_offsets.resize(chunkCount * RADIX_SORT_BUCKETS);
+
+	for (uint32_t shift = 0; shift < 32; shift += RADIX_SORT_BITS)
+	{
+		std::fill(m_offsets.begin(), m_offsets.end(), 0);
+		gVars->pThreadPool->ParallelFor(chunkCount, 1, [&](size_t chunk, size_t)
+		{
+			size_t* counts = &m_offsets[chunk * RADIX_SORT_BUCKETS];
+			size_t end = std::min(count, (chunk + 1) * chunkSize);
+			for (size_t i = chunk * chunkSize; i < end; ++i)
+			{
+				++counts[(keys[i] >> shift) & (RADIX_SORT_BUCKETS - 1)];
+			}
+		});
+
+		// Bucket major then chunk order keeps the sort stable
+		size_t total = 0;
+		bool sameDigit = false;
+		for (size_t bucket = 0; bucket < RADIX_SORT_BUCKETS; ++bucket)
+		{
+			size_t bucketCount = 0;
+			for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+			{
+				size_t& offset = m_offsets[chunk * RADIX_SORT_BUCKETS + bucket];
+				size_t digitCount = offset;
+				offset = total;
+				total += digitCount;
+				bucketCount += digitCount;
+			}
+			sameDigit = sameDigit || (bucketCount == count);
+		}
+		if (sameDigit)
+		{
+			continue;
+		}
+
+		gVars->pThreadPool->ParallelFor(chunkCount, 1, [&](size_t chunk, size_t)
+		{
+			size_t* offsets = &m_offsets[chunk * RADIX_SORT_BUCKETS];
+			size_t end = std::min(count, (chunk + 1) * chunkSize);
+			for (size_t i = chunk * chunkSize; i < end; ++i)
+			{
+				size_t destination = offsets[(keys[i] >> shift) & (RADIX_SORT_BUCKETS - 1)]++;
+				m_scratchKeys[destination] = keys[i];
+				m_scratchValues[destination] = values[i];
+			}
+		});
+
+		keys.swap(m_scratchKeys);
+		values.swap(m_scratchValues);
+	}
+}
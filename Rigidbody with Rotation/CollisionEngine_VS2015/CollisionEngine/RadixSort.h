@@ -0,0 +1,34 @@
+#ifndef _RADIX_SORT_H_
+#define _RADIX_SORT_H_
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+// One byte per pass
+#define RADIX_SORT_BITS		8
+#define RADIX_SORT_BUCKETS	(1 << RADIX_SORT_BITS)
+
+// Order preserving mapping of floats to unsigned integers, negative values end up below positive ones
+inline uint32_t	FloatToSortableKey(float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+// Stable LSD radix sort of keys with their values
+// Each pass counts then scatters in chunkCount slices run on the thread pool, passes where every key has the same digit are skipped
+// Scratch buffers keep their capacity from one sort to the next
+class CRadixSorter
+{
+public:
+	void	Sort(std::vector<uint32_t>& keys, std::vector<uint32_t>& values, size_t chunkCount);
+
+private:
+	std::vector<uint32_t>	m_scratchKeys;
+	std::vector<uint32_t>	m_scratchValues;
+	std::vector<size_t>		m_offsets; // [chunk][bucket]
+};
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef _RENDER_BACKEND_H_
+#define _RENDER_BACKEND_H_
+
+#include <string>
+#include <vector>
+
+struct SDebugVertex
+{
+	float	x, y;
+	float	r, g, b;
+};
+
+struct SRenderText
+{
+	SRenderText(const std::string& _text, int _x, int _y) : text(_text), x(_x), y(_y){}
+
+	std::string	text;
+	int x, y; // screen space (0,0) left bottom corner
+};
+
+class CPolygonBatch;
+
+// Every draw of a frame goes through the backend, CRenderer only decides what is drawn
+// See COpenGLRenderBackend and CSoftwareRenderBackend
+class IRenderBackend
+{
+public:
+	virtual ~IRenderBackend(){}
+
+	// Called once the window (and its context, if any) exists
+	virtual void	Init() = 0;
+	virtual void	Reshape(int width, int height) = 0;
+
+	// Clear the frame, world space is centered on the origin
+	virtual void	BeginFrame(float worldWidth, float worldHeight) = 0;
+	virtual void	EndFrame() = 0;
+
+	virtual void	DrawPolygonBatch(const CPolygonBatch& batch, float r, float g, float b) = 0;
+	// radius is in world units
+	virtual void	DrawPoints(const float* positionsX, const float* positionsY, size_t count, float radius, float r, float g, float b) = 0;
+	// 2 vertices per line
+	virtual void	DrawLines(const SDebugVertex* vertices, size_t vertexCount) = 0;
+	virtual void	DrawTexts(const std::vector<SRenderText>& texts) = 0;
+};
+
+#endif
@@ -0,0 +1,26 @@
+#include "RenderSnapshot.h"
+
+void	SRenderSnapshot::Clear()
+{
+	polygons.Clear();
+	pointSetCount = 0;
+	debugLines.clear();
+	texts.clear();
+	textLines.clear();
+}
+
+void	SRenderSnapshot::AddPoints(const float* positionsX, const float* positionsY, size_t count, float radius, float r, float g, float b)
+{
+	if (pointSetCount == pointSets.size())
+	{
+		pointSets.emplace_back();
+	}
+
+	SPointSet& pointSet = pointSets[pointSetCount++];
+	pointSet.positionsX.assign(positionsX, positionsX + count);
+	pointSet.positionsY.assign(positionsY, positionsY + count);
+	pointSet.radius = radius;
+	pointSet.r = r;
+	pointSet.g = g;
+	pointSet.b = b;
+}
@@ -0,0 +1,36 @@
+#ifndef _RENDER_SNAPSHOT_H_
+#define _RENDER_SNAPSHOT_H_
+
+#include <vector>
+#include <string>
+
+#include "PolygonBatch.h"
+#include "RenderBackend.h"
+
+struct SPointSet
+{
+	std::vector<float>	positionsX;
+	std::vector<float>	positionsY;
+	float				radius; // world units
+	float				r, g, b;
+};
+
+// Everything drawn for one physic tick, copied out of the world so the renderer
+// can read it while the next tick runs
+struct SRenderSnapshot
+{
+	void	Clear();
+	void	AddPoints(const float* positionsX, const float* positionsY, size_t count, float radius, float r, float g, float b);
+
+	CPolygonBatch				polygons;
+	std::vector<SPointSet>		pointSets; // only the first pointSetCount are used, the others keep their memory
+	size_t						pointSetCount = 0;
+
+	std::vector<SDebugVertex>	debugLines; // 2 vertices per line
+	std::vector<SRenderText>	texts;
+	std::vector<std::string>	textLines; // laid out by the renderer, after its own lines
+
+	size_t						tick = 0;
+};
+
+#endif
@@ -10,6 +10,11 @@ enum class Key : unsigned int
 	F3,
 	F4,
 	F5,
+	F6,
+	F7,
+	F8,
+	F9,
+	F10,
 
 	Count,
 };
@@ -1,5 +1,4 @@
 #include <stdlib.h>
-#include <GL/glew.h>
 
 #include <stdio.h>
 #include <iostream>
@@ -12,15 +11,31 @@
 #include "PhysicEngine.h"
 #include "SceneManager.h"
 #include "World.h"
+#include "PhysicThread.h"
 
-#include "drawtext.h"
+// Lines preallocated for a frame, more are still accepted
+#define DEBUG_LINES_CAPACITY	(1 << 16)
 
-CRenderer::CRenderer(float worldHeight)
-	: m_worldHeight(worldHeight), m_lastFPS(0.0f), m_lastFPSSince(0.0f), m_textCursor(0), m_FPS(FPS::Unlocked)
-{}
+// Set while the physic thread ticks, see CPhysicThread::Tick
+static thread_local SRenderSnapshot*	s_threadDrawTarget = nullptr;
+
+CRenderer::CRenderer(float worldHeight, IRenderBackend* backend)
+	: m_worldHeight(worldHeight), m_backend(backend), m_lastFPS(0.0f), m_lastFPSSince(0.0f), m_FPS(FPS::Unlocked)
+{
+	m_debugLines.reserve(2 * DEBUG_LINES_CAPACITY);
+	for (std::atomic<bool>& enabled : m_debugCategories)
+	{
+		enabled = true;
+	}
+}
 
 CRenderer::~CRenderer(){}
 
+IRenderBackend*	CRenderer::GetBackend() const
+{
+	return m_backend.get();
+}
+
 void CRenderer::SetWorldHeight(float worldHeight)
 {
 	m_worldHeight = worldHeight;
@@ -41,12 +56,15 @@ float	CRenderer::GetWorldHeight() const
 
 void CRenderer::DisplayText(const std::string& text)
 {
-	DisplayText(text, 50, gVars->pRenderWindow->Getheight() - 50 - 30 * m_textCursor++);
+	// Laid out in RenderTexts
+	std::vector<std::string>& textLines = s_threadDrawTarget ? s_threadDrawTarget->textLines : m_textLines;
+	textLines.push_back(text);
 }
 
 void CRenderer::DisplayText(const std::string& text, int x, int y)
 {
-	m_renderTexts.push_back(SRenderText(text, x, y));
+	std::vector<SRenderText>& texts = s_threadDrawTarget ? s_threadDrawTarget->texts : m_renderTexts;
+	texts.push_back(SRenderText(text, x, y));
 }
 
 void CRenderer::DisplayTextWorld(const std::string& text, const Vec2& worldPos)
@@ -56,13 +74,31 @@ void CRenderer::DisplayTextWorld(const std::string& text, const Vec2& worldPos)
 }
 
 
-void CRenderer::DrawLine(const Vec2& from, const Vec2& to, float r, float g, float b)
+void CRenderer::DrawLine(const Vec2& from, const Vec2& to, float r, float g, float b, EDebugCategory category)
+{
+	if (!m_debugCategories[(int)category])
+	{
+		return;
+	}
+
+	std::vector<SDebugVertex>& debugLines = s_threadDrawTarget ? s_threadDrawTarget->debugLines : m_debugLines;
+	debugLines.push_back({ from.x, from.y, r, g, b });
+	debugLines.push_back({ to.x, to.y, r, g, b });
+}
+
+void CRenderer::ToggleDebugCategory(EDebugCategory category)
+{
+	m_debugCategories[(int)category] = !m_debugCategories[(int)category];
+}
+
+bool CRenderer::IsDebugCategoryEnabled(EDebugCategory category) const
+{
+	return m_debugCategories[(int)category];
+}
+
+void CRenderer::SetThreadDrawTarget(SRenderSnapshot* snapshot)
 {
-	glColor3f(r, g, b);
-	glBegin(GL_LINES);
-	glVertex3f(from.x, from.y, -1.0f);
-	glVertex3f(to.x, to.y, -1.0f);
-	glEnd();
+	s_threadDrawTarget = snapshot;
 }
 
 Vec2 CRenderer::ScreenToWorldPos(const Vec2& pos) const
@@ -81,11 +117,26 @@ Vec2 CRenderer::WorldToScreenPos(const Vec2& pos) const
 	return pos * (height / m_worldHeight) + Vec2(width, height) * 0.5f;
 }
 
+SInputState CRenderer::SampleInput() const
+{
+	SInputState input;
+	input.mousePos = ScreenToWorldPos(gVars->pRenderWindow->GetMousePos());
+	for (int button = 0; button < INPUT_MOUSE_BUTTON_COUNT; ++button)
+	{
+		input.mouseButtons[button] = gVars->pRenderWindow->GetMouseButton(button);
+	}
+
+	input.worldWidth = GetWorldWidth();
+	input.worldHeight = m_worldHeight;
+	input.screenWidth = gVars->pRenderWindow->GetWidth();
+	input.screenHeight = gVars->pRenderWindow->Getheight();
+	return input;
+}
+
 void CRenderer::Init()
 {
-	// Init font
-	m_font = dtx_open_font("font.ttf", 24);
-	dtx_use_font(m_font, 24);
+	m_backend->Init();
+	m_backend->Reshape(gVars->pRenderWindow->GetWidth(), gVars->pRenderWindow->Getheight());
 
 	m_frameTimer.Start();
 
@@ -104,15 +155,18 @@ void CRenderer::Reset()
 
 void CRenderer::Reshape(int width, int height)
 {
-	glViewport(0, 0, width, height);
+	m_backend->Reshape(width, height);
 }
 
 void CRenderer::Update()
 {
 	CTimer timer;
+	CPhysicThread* physicThread = gVars->pPhysicThread;
 
+	// Only what changes the world waits for the current physic tick, the frame itself never does
 	if (gVars->pRenderWindow->JustPressedKey(Key::F4))
 	{
+		std::lock_guard<std::mutex> worldLock(physicThread->GetWorldMutex());
 		gVars->bDebug = !gVars->bDebug;
 		for (size_t i = 0; i < gVars->pWorld->GetPolygonCount(); ++i)
 		{
@@ -120,57 +174,102 @@ void CRenderer::Update()
 		}
 	}
 
+	if (gVars->pRenderWindow->JustPressedKey(Key::F6))
+	{
+		std::lock_guard<std::mutex> worldLock(physicThread->GetWorldMutex());
+		CTrajectoryRecorder& recorder = gVars->pPhysicEngine->GetTrajectoryRecorder();
+		if (recorder.IsRecording())
+		{
+			recorder.Stop();
+		}
+		else
+		{
+			recorder.Start("trajectories.trj");
+		}
+	}
+
+	const Key categoryKeys[] = { Key::F7, Key::F8, Key::F9, Key::F10 };
+	const EDebugCategory categories[] = { EDebugCategory::AABB, EDebugCategory::Minkowski, EDebugCategory::Simplex, EDebugCategory::Contact };
+	for (size_t i = 0; i < 4; ++i)
+	{
+		if (gVars->pRenderWindow->JustPressedKey(categoryKeys[i]))
+		{
+			ToggleDebugCategory(categories[i]);
+		}
+	}
+
 	gVars->pSceneManager->CheckSceneUpdate();
 
+	if (gVars->pPhysicEngine->GetTrajectoryRecorder().IsRecording())
+	{
+		DisplayText("Recording trajectories");
+	}
+
 	PreRenderFrame();
 
 	float frameTime = UpdateFrameTime();
 	DrawFPS(frameTime);
 
 
-	gVars->pPhysicEngine->Step(frameTime);
-	
-	timer.Start();
-	UpdateWorld(frameTime);
-	timer.Stop(); 
+	physicThread->SetInput(SampleInput());
+
+	// Without the physic thread running, tick it here with the frame time
+	if (!physicThread->IsRunning())
+	{
+		physicThread->Tick(frameTime);
+	}
+	physicThread->AcquireSnapshot();
+	const SRenderSnapshot& snapshot = physicThread->GetSnapshot();
+
+	m_lastPhysicDuration = physicThread->GetLastTickDuration();
 	if (gVars->bDebug)
 	{
-		DisplayText("Update duration: " + std::to_string(timer.GetDuration()));
+		DisplayText("Update duration: " + std::to_string(m_lastPhysicDuration));
 	}
 
 	timer.Start();
-	RenderPolygons();
+	RenderSnapshot(snapshot);
+	RenderDebugLines(snapshot);
 	timer.Stop();
+	m_lastRenderDuration = timer.GetDuration();
 	if (gVars->bDebug)
 	{
-		DisplayText("Render duration: " + std::to_string(timer.GetDuration()));
+		DisplayText("Render duration: " + std::to_string(m_lastRenderDuration));
+		if (m_FPS != FPS::Unlocked)
+		{
+			DisplayText("Frame jitter: " + std::to_string(m_framePacer.GetAverageJitter() * 1000.0f) + " ms, max " + std::to_string(m_framePacer.GetMaxJitter() * 1000.0f) + " ms");
+		}
 	}
 
-	RenderTexts();
+	RenderTexts(snapshot);
+	m_backend->EndFrame();
 
 	UpdateLockFPS();
 }
 
-void  CRenderer::SetProjectionMatrix()
+void CRenderer::SetFixedFrameTime(float frameTime)
 {
-	int width = gVars->pRenderWindow->GetWidth();
-	int height = gVars->pRenderWindow->Getheight();
-	float ratio = (float)width / (float)height;
+	m_fixedFrameTime = frameTime;
+}
 
-	glMatrixMode(GL_PROJECTION);
-	glLoadIdentity();
-	glOrtho(-m_worldHeight * 0.5f * ratio, m_worldHeight * 0.5f * ratio, -m_worldHeight * 0.5f, m_worldHeight * 0.5f, 0.1f, 10.0f);
+CFramePacer&	CRenderer::GetFramePacer()
+{
+	return m_framePacer;
 }
 
-void  CRenderer::PreRenderFrame()
+float	CRenderer::GetLastPhysicDuration() const
 {
-	glClearColor(0.05f, 0.05f, 0.05f, 0.05f);
-	glClear(GL_COLOR_BUFFER_BIT);
+	return m_lastPhysicDuration;
+}
 
-	SetProjectionMatrix();
+float	CRenderer::GetLastRenderDuration() const
+{
+	return m_lastRenderDuration;
+}
 
-	glMatrixMode(GL_MODELVIEW);
-	glTranslatef(0.0f, 0.0f, 0.0f); // move camera here
+void  CRenderer::PreRenderFrame()
+{
+	m_backend->BeginFrame(GetWorldWidth(), m_worldHeight);
 }
 
 void  CRenderer::DrawFPS(float frameTime)
@@ -190,57 +289,50 @@ void  CRenderer::DrawFPS(float frameTime)
 	DisplayText(std::string("FPS: ") + std::to_string(m_lastFPS), width - 200, height - 30);
 }
 
-void  CRenderer::UpdateWorld(float frameTime)
+void  CRenderer::RenderSnapshot(const SRenderSnapshot& snapshot)
 {
-	if (gVars->pWorld)
+	m_backend->DrawPolygonBatch(snapshot.polygons, 0.7f, 0.7f, 0.7f);
+
+	for (size_t i = 0; i < snapshot.pointSetCount; ++i)
 	{
-		gVars->pWorld->Update(frameTime);
+		const SPointSet& pointSet = snapshot.pointSets[i];
+		m_backend->DrawPoints(pointSet.positionsX.data(), pointSet.positionsY.data(), pointSet.positionsX.size(), pointSet.radius, pointSet.r, pointSet.g, pointSet.b);
 	}
 }
 
-void  CRenderer::RenderPolygons()
+void  CRenderer::RenderDebugLines(const SRenderSnapshot& snapshot)
 {
-	glColor3f(0.7f, 0.7f, 0.7f);
-
-	glPushMatrix();
-
-	if (gVars->pWorld)
+	// One draw for the snapshot lines and the ones of this thread
+	m_debugLines.insert(m_debugLines.end(), snapshot.debugLines.begin(), snapshot.debugLines.end());
+	if (m_debugLines.empty())
 	{
-		gVars->pWorld->RenderPolygons();
+		return;
 	}
 
-	glPopMatrix();
+	m_backend->DrawLines(m_debugLines.data(), m_debugLines.size());
+	m_debugLines.clear();
 }
 
-void  CRenderer::RenderTexts()
+void  CRenderer::RenderTexts(const SRenderSnapshot& snapshot)
 {
-	int width = gVars->pRenderWindow->GetWidth();
 	int height = gVars->pRenderWindow->Getheight();
 
-	//Light Gray text
-	glColor3f(0.7f, 0.7f, 0.7f);
-
-	// Set proj matrix to screen space
-	glMatrixMode(GL_PROJECTION);
-	glLoadIdentity();
-	glOrtho(0, width, 0, height, -1, 1);
-
-	// Reset model matrix
-	glMatrixMode(GL_MODELVIEW);
-	glLoadIdentity();
-
-	for (const SRenderText& text : m_renderTexts)
+	// Lines from the top left corner, the snapshot ones after ours
+	int cursor = 0;
+	for (const std::string& text : m_textLines)
 	{
-		glPushMatrix();
-
-		glTranslatef((float)text.x, (float)text.y, 0.0f);
-		dtx_string(text.text.c_str());
-
-		glPopMatrix();
+		m_renderTexts.push_back(SRenderText(text, 50, height - 50 - 30 * cursor++));
 	}
+	for (const std::string& text : snapshot.textLines)
+	{
+		m_renderTexts.push_back(SRenderText(text, 50, height - 50 - 30 * cursor++));
+	}
+	m_renderTexts.insert(m_renderTexts.end(), snapshot.texts.begin(), snapshot.texts.end());
+
+	m_backend->DrawTexts(m_renderTexts);
 
 	m_renderTexts.clear();
-	m_textCursor = 0;
+	m_textLines.clear();
 }
 
 void  CRenderer::UpdateLockFPS()
@@ -248,16 +340,16 @@ void  CRenderer::UpdateLockFPS()
 	if (gVars->pRenderWindow->JustPressedKey(Key::F5))
 	{
 		m_FPS = (FPS)(((int)m_FPS + 1) % (int)FPS::Count);
-	}
 
-	if (m_FPS != FPS::Unlocked)
-	{
-		float frameTimeLimit = (m_FPS == FPS::Locked30) ? 1.0f / 30.0f : 1.0f / 60.0f;
-		do
+		float frameTimeLimit = 0.0f;
+		if (m_FPS != FPS::Unlocked)
 		{
-			m_frameTimer.Stop();
-		} while (m_frameTimer.GetDuration() < frameTimeLimit);
+			frameTimeLimit = (m_FPS == FPS::Locked30) ? 1.0f / 30.0f : 1.0f / 60.0f;
+		}
+		m_framePacer.SetTargetFrameTime(frameTimeLimit);
 	}
+
+	m_framePacer.WaitForNextFrame();
 }
 
 float  CRenderer::UpdateFrameTime()
@@ -266,5 +358,5 @@ float  CRenderer::UpdateFrameTime()
 	float frameTime = m_frameTimer.GetDuration();
 	m_frameTimer.Start();
 
-	return frameTime;
+	return (m_fixedFrameTime > 0.0f) ? m_fixedFrameTime : frameTime;
 }
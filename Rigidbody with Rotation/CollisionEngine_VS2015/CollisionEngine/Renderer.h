@@ -2,9 +2,15 @@
 #define _RENDERER_H_
 
 #include <vector>
+#include <memory>
+#include <atomic>
 
 #include "Timer.h"
 #include "Maths.h"
+#include "RenderBackend.h"
+#include "RenderSnapshot.h"
+#include "InputState.h"
+#include "FramePacer.h"
 
 
 enum class FPS : int
@@ -16,20 +22,27 @@ enum class FPS : int
 	Count,
 };
 
-struct SRenderText
+// Debug lines can be toggled per category
+enum class EDebugCategory : int
 {
-	SRenderText(const std::string& _text, int _x, int _y) : text(_text), x(_x), y(_y){}
+	Default = 0,
+	AABB,
+	Minkowski,
+	Simplex,
+	Contact,
 
-	std::string	text;
-	int x, y; // screen space (0,0) left bottom corner
+	Count,
 };
 
 class CRenderer
 {
 public:
-	CRenderer(float worldHeight);
+	// Takes ownership of the backend
+	CRenderer(float worldHeight, IRenderBackend* backend);
 	~CRenderer();
 
+	IRenderBackend*	GetBackend() const;
+
 	void	SetWorldHeight(float worldHeight);
 	float	GetWorldWidth() const;
 	float	GetWorldHeight() const;
@@ -37,23 +50,42 @@ public:
 	void	DisplayText(const std::string& text);
 	void	DisplayText(const std::string& text, int x, int y);
 	void	DisplayTextWorld(const std::string& text, const Vec2& worldPos);
-	void	DrawLine(const Vec2& from, const Vec2& to, float r, float g, float b);
+	// Only stored, every line of the frame is drawn at once after the polygons
+	// Texts and lines go to the draw target of the calling thread when it has one
+	void	DrawLine(const Vec2& from, const Vec2& to, float r, float g, float b, EDebugCategory category = EDebugCategory::Default);
+
+	void	ToggleDebugCategory(EDebugCategory category);
+	bool	IsDebugCategoryEnabled(EDebugCategory category) const;
+
+	// Texts and lines of the calling thread go to snapshot until reset to nullptr
+	void	SetThreadDrawTarget(SRenderSnapshot* snapshot);
 
+	// Main thread only, the physic thread reads the window through SInputState
 	Vec2	ScreenToWorldPos(const Vec2& pos) const;
 	Vec2	WorldToScreenPos(const Vec2& pos) const;
+	SInputState	SampleInput() const;
 
 	void	Init();
 	void	Reset();
 	void	Reshape(int width, int height);
 	void	Update();
 
+	// 0 uses the measured frame time
+	void	SetFixedFrameTime(float frameTime);
+
+	// Paces frames while the FPS are locked (F5)
+	CFramePacer&	GetFramePacer();
+
+	// Durations of the last Update, in seconds
+	float	GetLastPhysicDuration() const;
+	float	GetLastRenderDuration() const;
+
 private:
-	void	SetProjectionMatrix();
 	void	PreRenderFrame();
 	void	DrawFPS(float frameTime);
-	void	UpdateWorld(float frameTime);
-	void	RenderPolygons();
-	void	RenderTexts();
+	void	RenderSnapshot(const SRenderSnapshot& snapshot);
+	void	RenderDebugLines(const SRenderSnapshot& snapshot);
+	void	RenderTexts(const SRenderSnapshot& snapshot);
 	void	UpdateLockFPS();
 
 	float	UpdateFrameTime();
@@ -61,12 +93,19 @@ private:
 private:
 	float m_worldHeight; // height in world units
 
+	std::unique_ptr<IRenderBackend>	m_backend;
+
 	CTimer m_frameTimer;
+	CFramePacer	m_framePacer;
 
 	std::vector<SRenderText>	m_renderTexts;
-	int							m_textCursor;
+	std::vector<std::string>	m_textLines;
+	std::vector<SDebugVertex>	m_debugLines; // 2 vertices per line
+	std::atomic<bool>			m_debugCategories[(int)EDebugCategory::Count]; // read by the physic thread
 
-	struct dtx_font* m_font;
+	float	m_fixedFrameTime = 0.0f;
+	float	m_lastPhysicDuration = 0.0f;
+	float	m_lastRenderDuration = 0.0f;
 
 	float	m_lastFPS;
 	float	m_lastFPSSince;
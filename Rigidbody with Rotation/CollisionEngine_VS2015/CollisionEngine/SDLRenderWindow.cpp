@@ -6,6 +6,7 @@
 
 #include "GlobalVariables.h"
 #include "Renderer.h"
+#include "PhysicThread.h"
 
 CSDLRenderWindow::CSDLRenderWindow(int width, int height) 
 	: CRenderWindow(width, height)
@@ -17,6 +18,11 @@ CSDLRenderWindow::CSDLRenderWindow(int width, int height)
 	m_sdlKeyMap[SDL_SCANCODE_F3] = Key::F3;
 	m_sdlKeyMap[SDL_SCANCODE_F4] = Key::F4;
 	m_sdlKeyMap[SDL_SCANCODE_F5] = Key::F5;
+	m_sdlKeyMap[SDL_SCANCODE_F6] = Key::F6;
+	m_sdlKeyMap[SDL_SCANCODE_F7] = Key::F7;
+	m_sdlKeyMap[SDL_SCANCODE_F8] = Key::F8;
+	m_sdlKeyMap[SDL_SCANCODE_F9] = Key::F9;
+	m_sdlKeyMap[SDL_SCANCODE_F10] = Key::F10;
 }
 
 void CSDLRenderWindow::Init()
@@ -43,7 +49,12 @@ void CSDLRenderWindow::Init()
 	context = SDL_GL_CreateContext(window);
 	SDL_GL_SetSwapInterval(0);
 
+	// Load buffer functions and detect extensions (GL_ARB_buffer_storage)
+	glewExperimental = GL_TRUE;
+	glewInit();
+
 	gVars->pRenderer->Init();
+	gVars->pPhysicThread->Start();
 
 	while (ProcessEvents())
 	{
@@ -51,6 +62,7 @@ void CSDLRenderWindow::Init()
 		SDL_GL_SwapWindow(window);
 	}
 
+	gVars->pPhysicThread->Stop();
 	gVars->pRenderer->Reset();
 
 	SDL_GL_DeleteContext(context);
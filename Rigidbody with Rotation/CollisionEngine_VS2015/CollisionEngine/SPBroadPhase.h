@@ -3,47 +3,321 @@
 
 #include "BroadPhase.h"
 #include <algorithm>
+#include "AABBTree.h"
+#include "RadixSort.h"
 #include "Polygon.h"
 #include "GlobalVariables.h"
+#include "PhysicEngine.h"
+#include "ThreadPool.h"
 #include "World.h"
 
-//Instead of BroadPhaseBrut, SPBroadPhase sorts the polygon according to their min.x first, then min.y
+// Polygons wider than this many times the median width are not swept by queries but always tested
+#define SP_WIDE_POLYGON_FACTOR	4.0f
+// Under this many moving polygons, sort and sweep run on the calling thread only
+#define SP_PARALLEL_MIN_POLYGONS	4096
+// Polygons swept per job, each job fills its own pair buffer
+#define SP_SWEEP_CHUNK_SIZE		1024
+
+// Sort and prune instead of BroadPhaseBrut : polygons are sorted by their AABB minimum along one axis, then swept
+// The axis is the one where polygon centers spread the most (largest variance), the minimums are radix sorted
+// Sort and sweep are split on the thread pool for big worlds, pairs come out in the same order either way
+// Static polygons (density 0) are kept apart in a tree built once, only queried by the moving ones
+// A static polygon that moves is swept with the moving ones (kinematic) until the static set is rebuilt
 class CSPBroadPhase : public IBroadPhase
 {
 public:
+	virtual void Update() override
+	{
+		size_t worldCount = gVars->pWorld->GetPolygonCount();
+
+		// Statics added, removed or reordered since the tree was built ask for a rebuild
+		bool staticsChanged = (worldCount != m_staticBodies.size());
+		for (size_t i = 0; i < worldCount && !staticsChanged; i++)
+		{
+			const CPolygonPtr& poly = gVars->pWorld->GetPolygon(i);
+			if (poly->density != 0.0f)
+			{
+				staticsChanged = (m_staticBodies[i] != nullptr);
+				continue;
+			}
+
+			staticsChanged = (m_staticBodies[i] != poly.get());
+		}
+		if (staticsChanged)
+		{
+			BuildStatics();
+		}
+
+		m_movingIndices.clear();
+		Vec2 centerSum, centerSqrSum;
+		for (size_t i = 0; i < worldCount; i++)
+		{
+			const CPolygonPtr& poly = gVars->pWorld->GetPolygon(i);
+			const AABB& aabb = *poly->GetOwnAABB();
+			if (poly->density == 0.0f)
+			{
+				if (!m_kinematic[i])
+				{
+					m_staticFilters[m_staticLeaves[i]] = poly->filter;
+				}
+
+				const AABB& builtAABB = m_staticBounds[i];
+				m_kinematic[i] = m_kinematic[i] || !(aabb.min == builtAABB.min) || !(aabb.max == builtAABB.max);
+				if (!m_kinematic[i])
+				{
+					continue;
+				}
+			}
+			m_movingIndices.push_back((uint32_t)i);
+
+			Vec2 center = (aabb.min + aabb.max) * 0.5f;
+			centerSum += center;
+			centerSqrSum += Vec2(center.x * center.x, center.y * center.y);
+		}
+		size_t polyCount = m_movingIndices.size();
+
+		// Sweep along the axis of largest variance, fewer polygons overlap on it
+		if (polyCount > 0)
+		{
+			Vec2 mean = centerSum / (float)polyCount;
+			Vec2 variance = centerSqrSum / (float)polyCount - Vec2(mean.x * mean.x, mean.y * mean.y);
+			m_sweepAxis = (variance.y > variance.x) ? 1 : 0;
+		}
+
+		// Small worlds take a single chunk, which the pool runs on the calling thread
+		bool parallel = (polyCount >= SP_PARALLEL_MIN_POLYGONS);
+		size_t chunkSize = parallel ? SP_SWEEP_CHUNK_SIZE : polyCount;
+		size_t chunkCount = parallel ? (polyCount + SP_SWEEP_CHUNK_SIZE - 1) / SP_SWEEP_CHUNK_SIZE : 1;
+
+		m_sortKeys.resize(polyCount);
+		m_sortIndices.resize(polyCount);
+		gVars->pThreadPool->ParallelFor(polyCount, chunkSize, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				m_sortKeys[i] = FloatToSortableKey(GetAxis(gVars->pWorld->GetPolygon(m_movingIndices[i])->GetOwnAABB()->min));
+				m_sortIndices[i] = m_movingIndices[i];
+			}
+		});
+		m_sorter.Sort(m_sortKeys, m_sortIndices, chunkCount);
+
+		// Sweep data copied in sorted order, queries start from the first min a polygon of maxWidth could overlap from
+		m_polyPtrVector.resize(polyCount);
+		m_sweepMin.resize(polyCount);
+		m_sweepMax.resize(polyCount);
+		m_otherMin.resize(polyCount);
+		m_otherMax.resize(polyCount);
+		m_widths.resize(polyCount);
+		m_filters.resize(polyCount);
+		m_isStatic.resize(polyCount);
+		gVars->pThreadPool->ParallelFor(polyCount, chunkSize, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				m_polyPtrVector[i] = gVars->pWorld->GetPolygon(m_sortIndices[i]);
+				CPolygon* poly = m_polyPtrVector[i].get();
+				const AABB& aabb = *poly->GetOwnAABB();
+				m_sweepMin[i] = GetAxis(aabb.min);
+				m_sweepMax[i] = GetAxis(aabb.max);
+				m_otherMin[i] = GetOtherAxis(aabb.min);
+				m_otherMax[i] = GetOtherAxis(aabb.max);
+				m_widths[i] = m_sweepMax[i] - m_sweepMin[i];
+				m_filters[i] = poly->filter;
+				m_isStatic[i] = (poly->density == 0.0f);
+			}
+		});
+
+		// Borders and other long polygons would make every query sweep the whole world
+		m_widePolygons.clear();
+		m_maxWidth = 0.0f;
+		if (polyCount > 0)
+		{
+			TFrameVector<float> widths(m_widths.begin(), m_widths.end(), gVars->pPhysicEngine->GetFrameArena());
+			std::nth_element(widths.begin(), widths.begin() + polyCount / 2, widths.end());
+			float wideWidth = widths[polyCount / 2] * SP_WIDE_POLYGON_FACTOR;
+
+			for (size_t i = 0; i < polyCount; ++i)
+			{
+				if (m_widths[i] > wideWidth)
+				{
+					m_widePolygons.push_back(i);
+				}
+				else
+				{
+					m_maxWidth = Max(m_maxWidth, m_widths[i]);
+				}
+			}
+		}
+	}
+
 	virtual void GetCollidingPairsToCheck(std::vector<SPolygonPair>& pairsToCheck) override
 	{
-		std::vector<CPolygonPtr> polyPtrVector;
-		size_t polyCount = gVars->pWorld->GetPolygonCount();
-		//used for optimization
-		polyPtrVector.reserve(polyCount);
+		size_t polyCount = m_polyPtrVector.size();
+		if (polyCount < SP_PARALLEL_MIN_POLYGONS)
+		{
+			SweepRange(0, polyCount, pairsToCheck);
+			return;
+		}
 
-		for (size_t i = 0; i < polyCount; i++)
+		// Jobs sweep from their own polygons to the end, their buffers are appended in order
+		size_t chunkCount = (polyCount + SP_SWEEP_CHUNK_SIZE - 1) / SP_SWEEP_CHUNK_SIZE;
+		m_chunkPairs.resize(chunkCount);
+		gVars->pThreadPool->ParallelFor(polyCount, SP_SWEEP_CHUNK_SIZE, [&](size_t begin, size_t end)
 		{
-			polyPtrVector.push_back(gVars->pWorld->GetPolygon(i));
+			std::vector<SPolygonPair>& chunkPairs = m_chunkPairs[begin / SP_SWEEP_CHUNK_SIZE];
+			chunkPairs.clear();
+			SweepRange(begin, end, chunkPairs);
+		});
+
+		size_t pairCount = pairsToCheck.size();
+		for (const std::vector<SPolygonPair>& chunkPairs : m_chunkPairs)
+		{
+			pairCount += chunkPairs.size();
+		}
+		pairsToCheck.reserve(pairCount);
+		for (const std::vector<SPolygonPair>& chunkPairs : m_chunkPairs)
+		{
+			pairsToCheck.insert(pairsToCheck.end(), chunkPairs.begin(), chunkPairs.end());
+		}
+	}
+
+	virtual void QueryAABB(const AABB& box, std::vector<CPolygonPtr>& polygons) const override
+	{
+		size_t first = std::lower_bound(m_sweepMin.begin(), m_sweepMin.end(), GetAxis(box.min) - m_maxWidth) - m_sweepMin.begin();
+		for (size_t i = first; i < m_sweepMin.size() && m_sweepMin[i] <= GetAxis(box.max); ++i)
+		{
+			if (m_widths[i] <= m_maxWidth && AABBOverlap(*m_polyPtrVector[i]->aabb, box))
+			{
+				polygons.push_back(m_polyPtrVector[i]);
+			}
 		}
 
-		//Please refer to the README to see where this method comes from
-		std::sort(polyPtrVector.begin(), polyPtrVector.end());
+		for (size_t i : m_widePolygons)
+		{
+			if (AABBOverlap(*m_polyPtrVector[i]->aabb, box))
+			{
+				polygons.push_back(m_polyPtrVector[i]);
+			}
+		}
 
-		for (size_t i = 0; i < polyCount; ++i)
+		m_staticTree.ForEachOverlap(box, [&](size_t leaf)
+		{
+			size_t index = m_staticIndices[leaf];
+			if (!m_kinematic[index])
+			{
+				polygons.push_back(gVars->pWorld->GetPolygon(index));
+			}
+		});
+	}
+
+private:
+	float GetAxis(const Vec2& point) const
+	{
+		return (m_sweepAxis == 0) ? point.x : point.y;
+	}
+
+	float GetOtherAxis(const Vec2& point) const
+	{
+		return (m_sweepAxis == 0) ? point.y : point.x;
+	}
+
+	// Pairs of the sorted polygons [begin, end) with the ones after them, and with the statics
+	void SweepRange(size_t begin, size_t end, std::vector<SPolygonPair>& pairsToCheck) const
+	{
+		size_t polyCount = m_polyPtrVector.size();
+		for (size_t i = begin; i < end; ++i)
 		{
 			for (size_t j = i + 1; j < polyCount; ++j)
 			{
 				//if not, no need to go on on onther points
-				if (polyPtrVector[i]->GetOwnAABB()->max.x > polyPtrVector[j]->GetOwnAABB()->min.x)
+				if (m_sweepMax[i] > m_sweepMin[j])
 				{
-					if(polyPtrVector[i]->GetOwnAABB()->max.y > polyPtrVector[j]->GetOwnAABB()->min.y
-						&& polyPtrVector[i]->GetOwnAABB()->min.y < polyPtrVector[j]->GetOwnAABB()->max.y)
-						pairsToCheck.push_back(SPolygonPair(polyPtrVector[i], polyPtrVector[j]));
+					if (m_otherMax[i] > m_otherMin[j] && m_otherMin[i] < m_otherMax[j]
+						&& !(m_isStatic[i] && m_isStatic[j])
+						&& ShouldCollide(m_filters[i], m_filters[j]))
+						pairsToCheck.push_back(SPolygonPair(m_polyPtrVector[i], m_polyPtrVector[j]));
 				}
 				else
 				{
 					break;
 				}
 			}
+
+			// Kinematic polygons don't meet statics either
+			if (m_isStatic[i])
+			{
+				continue;
+			}
+			const CPolygonPtr& poly = m_polyPtrVector[i];
+			m_staticTree.ForEachOverlap(*poly->GetOwnAABB(), [&](size_t leaf)
+			{
+				size_t index = m_staticIndices[leaf];
+				if (!m_kinematic[index] && ShouldCollide(m_filters[i], m_staticFilters[leaf]))
+				{
+					pairsToCheck.push_back(SPolygonPair(poly, gVars->pWorld->GetPolygon(index)));
+				}
+			});
 		}
 	}
+
+	void BuildStatics()
+	{
+		size_t worldCount = gVars->pWorld->GetPolygonCount();
+		m_staticBodies.assign(worldCount, nullptr);
+		m_staticBounds.resize(worldCount);
+		m_kinematic.assign(worldCount, false);
+		m_staticLeaves.assign(worldCount, 0);
+		m_staticIndices.clear();
+		m_staticFilters.clear();
+
+		std::vector<AABB> treeBounds;
+		for (size_t i = 0; i < worldCount; ++i)
+		{
+			const CPolygonPtr& poly = gVars->pWorld->GetPolygon(i);
+			if (poly->density != 0.0f)
+			{
+				continue;
+			}
+
+			m_staticBodies[i] = poly.get();
+			m_staticBounds[i] = *poly->GetOwnAABB();
+			m_staticLeaves[i] = m_staticIndices.size();
+			m_staticIndices.push_back(i);
+			m_staticFilters.push_back(poly->filter);
+			treeBounds.push_back(m_staticBounds[i]);
+		}
+
+		m_staticTree.Build(treeBounds);
+	}
+
+	std::vector<uint32_t>		m_movingIndices; // world indices, before sorting
+	std::vector<uint32_t>		m_sortKeys;
+	std::vector<uint32_t>		m_sortIndices; // world indices
+	CRadixSorter				m_sorter;
+	int							m_sweepAxis = 0; // 0 for x, 1 for y
+
+	// Sorted by min on the sweep axis
+	std::vector<CPolygonPtr>	m_polyPtrVector;
+	std::vector<float>			m_sweepMin;
+	std::vector<float>			m_sweepMax;
+	std::vector<float>			m_otherMin;
+	std::vector<float>			m_otherMax;
+	std::vector<float>			m_widths;
+	std::vector<SCollisionFilter>	m_filters; // copied next to the sweep data, pairs are filtered before being emitted
+	std::vector<uint8_t>		m_isStatic; // kinematic
+	std::vector<size_t>			m_widePolygons;
+	float						m_maxWidth = 0.0f; // of the polygons that are not wide
+
+	// Indexed like the world polygons when the static tree was built
+	CAABBTree						m_staticTree; // leaves index m_staticIndices and m_staticFilters
+	std::vector<size_t>				m_staticIndices;
+	std::vector<SCollisionFilter>	m_staticFilters;
+	std::vector<size_t>				m_staticLeaves; // world index to tree leaf
+	std::vector<const CPolygon*>	m_staticBodies; // nullptr if not static
+	std::vector<AABB>				m_staticBounds;
+	std::vector<bool>				m_kinematic; // static polygons that moved since
+
+	std::vector<std::vector<SPolygonPair>>	m_chunkPairs; // one per sweep job
 };
 
 #endif
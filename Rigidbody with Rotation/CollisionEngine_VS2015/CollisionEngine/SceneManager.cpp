@@ -8,6 +8,7 @@
 #include "World.h"
 #include "RenderWindow.h"
 #include "Renderer.h"
+#include "PhysicThread.h"
 
 void CSceneManager::Reset()
 {
@@ -42,6 +43,9 @@ void CSceneManager::LoadScene(size_t index)
 		behavior->Start();
 	});
 
+	// Scenes set the world height, the first tick must not wait for the next frame to see it
+	gVars->pPhysicThread->SetInput(gVars->pRenderer->SampleInput());
+
 	m_currentScene = index;
 }
 
@@ -52,31 +56,28 @@ void CSceneManager::ReloadScene()
 
 void CSceneManager::CheckSceneUpdate()
 {
-	gVars->pRenderer->DisplayText("F1: Reset scene, F2: prev scene, F3: next scene, cur scene: " + std::to_string(m_currentScene) + ", F4: debug, F5: lock FPS");
+	gVars->pRenderer->DisplayText("F1: Reset scene, F2: prev scene, F3: next scene, cur scene: " + std::to_string(m_currentScene) + ", F4: debug, F5: lock FPS, F6: record trajectories");
+	gVars->pRenderer->DisplayText("Debug lines F7: AABBs, F8: Minkowski hulls, F9: simplices, F10: contacts");
 
+	size_t sceneToLoad = m_scenes.size();
 	if (gVars->pRenderWindow->JustPressedKey(Key::F2) && m_currentScene > 0)
 	{
-		LoadScene(m_currentScene - 1);
-
-		for (size_t i = 0; i < gVars->pWorld->GetPolygonCount(); ++i)
-		{
-			if (gVars->bDebug)
-				gVars->pWorld->GetPolygon(i)->aabb->ToggleDisplaying();
-		}
+		sceneToLoad = m_currentScene - 1;
 	}
 	else if (gVars->pRenderWindow->JustPressedKey(Key::F3) && m_currentScene + 1 < m_scenes.size())
 	{
-		LoadScene(m_currentScene + 1);
-
-		for (size_t i = 0; i < gVars->pWorld->GetPolygonCount(); ++i)
-		{
-			if (gVars->bDebug)
-				gVars->pWorld->GetPolygon(i)->aabb->ToggleDisplaying();
-		}
+		sceneToLoad = m_currentScene + 1;
 	}
 	else if (gVars->pRenderWindow->JustPressedKey(Key::F1))
 	{
-		ReloadScene();
+		sceneToLoad = m_currentScene;
+	}
+
+	if (sceneToLoad < m_scenes.size())
+	{
+		// The world is replaced, wait for the current physic tick
+		std::lock_guard<std::mutex> worldLock(gVars->pPhysicThread->GetWorldMutex());
+		LoadScene(sceneToLoad);
 
 		for (size_t i = 0; i < gVars->pWorld->GetPolygonCount(); ++i)
 		{
@@ -30,7 +30,8 @@ protected:
 		params.maxPoints = 8;
 		params.minSpeed = 1.0f;
 		params.maxSpeed = 3.0f;
-		
+		params.concavity = 0.5f;
+
 		for (size_t i = 0; i < m_polyCount; ++i)
 		{
 			gVars->pWorld->AddRandomPoly(params);// ->density = 0.0f;
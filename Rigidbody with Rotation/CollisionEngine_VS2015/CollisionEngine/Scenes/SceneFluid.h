@@ -0,0 +1,25 @@
+#ifndef _SCENE_FLUID_H_
+#define _SCENE_FLUID_H_
+
+#include "BaseScene.h"
+
+#include "Behaviors/FluidSimulation.h"
+
+class CSceneFluid : public IScene
+{
+public:
+	CSceneFluid(size_t particleCount) : m_particleCount(particleCount){}
+
+private:
+	virtual void Create() override
+	{
+		gVars->pRenderer->SetWorldHeight(50.0f);
+
+		CBehaviorPtr fluid = gVars->pWorld->AddBehavior<CFluidSimulation>(nullptr);
+		std::static_pointer_cast<CFluidSimulation>(fluid)->SetParticleCount(m_particleCount);
+	}
+
+	size_t m_particleCount;
+};
+
+#endif
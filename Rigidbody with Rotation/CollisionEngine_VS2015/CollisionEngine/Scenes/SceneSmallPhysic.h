@@ -27,7 +27,7 @@ private:
 			}
 		}		
 		
-		CPolygonPtr circle = gVars->pWorld->AddSymetricPolygon(1.0f * m_scale, 50);
+		CPolygonPtr circle = gVars->pWorld->AddCircle(1.0f * m_scale);
 		circle->position = Vec2(5.0f * m_scale, -2.5f * m_scale);
 		
 		
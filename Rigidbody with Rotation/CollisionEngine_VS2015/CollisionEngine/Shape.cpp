@@ -0,0 +1,238 @@
+#include "Shape.h"
+
+#include "InertiaTensor.h"
+#include "Geometry.h"
+
+CShape::CShape(const std::vector<Vec2>& points)
+	: m_type(EShapeType::Polygon), m_radius(0.0f), m_signedArea(0.0f), m_localInertiaTensor(0.0f), m_boundingRadius(0.0f)
+{
+	std::vector<std::vector<Vec2>> pieces;
+	if (IsConvexPolygon(points) || DecomposeConvex(points, pieces))
+	{
+		m_points.assign(points.begin(), points.end());
+	}
+	else
+	{
+		std::vector<Vec2> hull = points;
+		ComputeConvexHull(hull);
+		m_points.assign(hull.begin(), hull.end());
+	}
+
+	ComputeArea();
+	RecenterOnCenterOfMass();
+	ComputeLocalInertiaTensor();
+	ComputeBounds();
+	BuildLines();
+	DetectBox();
+
+	if (pieces.size() > 1)
+	{
+		BuildChildren(pieces);
+	}
+}
+
+CShape::CShape(float radius, size_t outlineSegments)
+	: m_type(EShapeType::Circle), m_radius(radius), m_signedArea(0.0f), m_localInertiaTensor(0.0f), m_boundingRadius(0.0f)
+{
+	float dAngle = 360.0f / (float)outlineSegments;
+	for (size_t i = 0; i < outlineSegments; ++i)
+	{
+		float angle = i * dAngle;
+		m_points.push_back(Vec2(cosf(DEG2RAD(angle)), sinf(DEG2RAD(angle))) * radius);
+	}
+
+	m_signedArea = (float)M_PI * radius * radius;
+	m_localInertiaTensor = 0.5f * radius * radius;
+	ComputeBounds();
+}
+
+EShapeType	CShape::GetType() const
+{
+	return m_type;
+}
+
+float	CShape::GetRadius() const
+{
+	return m_radius;
+}
+
+const TShapeArray<Vec2>&	CShape::GetPoints() const
+{
+	return m_points;
+}
+
+const TShapeArray<Line>&	CShape::GetLines() const
+{
+	return m_lines;
+}
+
+const TShapeArray<Vec2>&	CShape::GetNormals() const
+{
+	return m_normals;
+}
+
+bool	CShape::IsBox() const
+{
+	return m_isBox;
+}
+
+const Vec2&	CShape::GetBoxAxis() const
+{
+	return m_boxAxis;
+}
+
+const Vec2&	CShape::GetBoxHalfExtents() const
+{
+	return m_boxHalfExtents;
+}
+
+float	CShape::GetArea() const
+{
+	return fabsf(m_signedArea);
+}
+
+float	CShape::GetLocalInertiaTensor() const
+{
+	return m_localInertiaTensor;
+}
+
+const Vec2&	CShape::GetCentroid() const
+{
+	return m_centroid;
+}
+
+const AABB&	CShape::GetLocalBounds() const
+{
+	return m_localBounds;
+}
+
+float	CShape::GetBoundingRadius() const
+{
+	return m_boundingRadius;
+}
+
+const std::vector<std::shared_ptr<const CShape>>&	CShape::GetChildren() const
+{
+	return m_children;
+}
+
+void CShape::BuildChildren(std::vector<std::vector<Vec2>>& pieces)
+{
+	m_type = EShapeType::Compound;
+
+	for (std::vector<Vec2>& piece : pieces)
+	{
+		for (Vec2& point : piece)
+		{
+			point -= m_centroid;
+		}
+		m_children.push_back(std::make_shared<CShape>(piece));
+	}
+
+	std::vector<AABB> childBounds;
+	for (const CShapePtr& child : m_children)
+	{
+		AABB bounds = child->GetLocalBounds();
+		bounds.min += child->GetCentroid();
+		bounds.max += child->GetCentroid();
+		childBounds.push_back(bounds);
+	}
+	m_childTree.Build(childBounds);
+}
+
+void CShape::BuildLines()
+{
+	m_lines.clear();
+	m_normals.clear();
+	for (size_t index = 0; index < m_points.size(); ++index)
+	{
+		const Vec2& pointA = m_points[index];
+		const Vec2& pointB = m_points[(index + 1) % m_points.size()];
+
+		Vec2 lineDir = (pointA - pointB).Normalized();
+
+		m_lines.push_back(Line(pointB, lineDir, (pointA - pointB).GetLength()));
+		m_normals.push_back(m_lines.back().GetNormal());
+	}
+}
+
+void CShape::ComputeArea()
+{
+	m_signedArea = 0.0f;
+	for (size_t index = 0; index < m_points.size(); ++index)
+	{
+		const Vec2& pointA = m_points[index];
+		const Vec2& pointB = m_points[(index + 1) % m_points.size()];
+		m_signedArea += pointA.x * pointB.y - pointB.x * pointA.y;
+	}
+	m_signedArea *= 0.5f;
+}
+
+void CShape::RecenterOnCenterOfMass()
+{
+	Vec2 centroid;
+	for (size_t index = 0; index < m_points.size(); ++index)
+	{
+		const Vec2& pointA = m_points[index];
+		const Vec2& pointB = m_points[(index + 1) % m_points.size()];
+		float factor = pointA.x * pointB.y - pointB.x * pointA.y;
+		centroid.x += (pointA.x + pointB.x) * factor;
+		centroid.y += (pointA.y + pointB.y) * factor;
+	}
+	centroid /= 6.0f * m_signedArea;
+
+	for (Vec2& point : m_points)
+	{
+		point -= centroid;
+	}
+	m_centroid = centroid;
+}
+
+void CShape::ComputeLocalInertiaTensor()
+{
+	m_localInertiaTensor = 0.0f;
+	for (size_t i = 0; i + 1 < m_points.size(); ++i)
+	{
+		const Vec2& pointA = m_points[i];
+		const Vec2& pointB = m_points[i + 1];
+
+		m_localInertiaTensor += ComputeInertiaTensor_Triangle(Vec2(), pointA, pointB);
+	}
+}
+
+void CShape::ComputeBounds()
+{
+	m_localBounds.Center(Vec2());
+	m_localBounds.bIsColliding = false;
+	m_localBounds.bIsDisplayed = false;
+	m_boundingRadius = 0.0f;
+
+	for (const Vec2& point : m_points)
+	{
+		m_localBounds.Extend(point);
+		m_boundingRadius = Max(m_boundingRadius, point.GetLength());
+	}
+}
+
+void CShape::DetectBox()
+{
+	if (m_points.size() != 4)
+	{
+		return;
+	}
+
+	// Opposite edges are equal and the first two are perpendicular
+	Vec2 edge0 = m_points[1] - m_points[0];
+	Vec2 edge1 = m_points[2] - m_points[1];
+	Vec2 edge2 = m_points[3] - m_points[2];
+	Vec2 edge3 = m_points[0] - m_points[3];
+	float epsilon = SHAPE_BOX_EPSILON * (edge0.GetSqrLength() + edge1.GetSqrLength());
+	if ((edge0 + edge2).GetSqrLength() > epsilon || (edge1 + edge3).GetSqrLength() > epsilon || fabsf(edge0 | edge1) > epsilon)
+	{
+		return;
+	}
+
+	m_isBox = true;
+	m_boxAxis = edge0.Normalized();
+	m_boxHalfExtents = Vec2(edge0.GetLength(), edge1.GetLength()) * 0.5f;
+}
@@ -0,0 +1,107 @@
+#ifndef _SHAPE_H_
+#define _SHAPE_H_
+
+#include <vector>
+#include <memory>
+
+#include "Maths.h"
+#include "AABBTree.h"
+#include "InlineVector.h"
+
+// Random polygons have 3 to 8 vertices (see SRandomPolyParams), bigger hulls and circle outlines spill to the heap
+#define SHAPE_INLINE_VERTICES	8
+// Relative to the squared edge lengths, for box detection
+#define SHAPE_BOX_EPSILON		1e-6f
+
+// Per vertex or per edge data, stored in the shape itself up to SHAPE_INLINE_VERTICES
+template<typename T>
+using TShapeArray = TInlineVector<T, SHAPE_INLINE_VERTICES>;
+
+enum class EShapeType : int
+{
+	Polygon = 0,
+	Circle,
+	Compound, // concave polygon, collides through its convex children
+
+	Count,
+};
+
+// Immutable shape data, shared by every polygon built from the same points
+class CShape
+{
+public:
+	// points are recentered on the center of mass, see GetCentroid()
+	// Concave outlines are split into convex children, self intersecting ones are replaced by their convex hull
+	CShape(const std::vector<Vec2>& points);
+	// Circle centered on the origin, points are only an outline used for drawing
+	CShape(float radius, size_t outlineSegments = 32);
+
+	CShape(const CShape&) = delete;
+	CShape& operator=(const CShape&) = delete;
+
+	EShapeType			GetType() const;
+	float				GetRadius() const; // circles only
+
+	const TShapeArray<Vec2>&	GetPoints() const;
+	const TShapeArray<Line>&	GetLines() const;
+	// Outward normal of each line, normals[i] is lines[i].GetNormal()
+	const TShapeArray<Vec2>&	GetNormals() const;
+
+	// Rectangles, in any orientation : points are center +- boxAxis * halfExtents.x +- boxAxis.GetNormal() * halfExtents.y
+	bool				IsBox() const;
+	const Vec2&			GetBoxAxis() const;
+	const Vec2&			GetBoxHalfExtents() const;
+
+	float				GetArea() const;
+	float				GetLocalInertiaTensor() const; // don't consider mass
+
+	// Offset between the given points and the recentered ones
+	const Vec2&			GetCentroid() const;
+	const AABB&			GetLocalBounds() const;
+	float				GetBoundingRadius() const;
+
+	// Compound only : convex pieces of the outline, their centroid is their offset in this shape local space
+	const std::vector<std::shared_ptr<const CShape>>&	GetChildren() const;
+
+	// functor(childIndex) for each child whose bounds overlap box, given in this shape local space
+	template<typename TFunctor>
+	void				ForEachOverlappingChild(const AABB& box, TFunctor functor) const
+	{
+		m_childTree.ForEachOverlap(box, functor);
+	}
+
+private:
+	void				BuildChildren(std::vector<std::vector<Vec2>>& pieces);
+
+	void				BuildLines();
+	void				ComputeArea();
+	void				RecenterOnCenterOfMass(); // Area must be computed
+	void				ComputeLocalInertiaTensor(); // Must be centered on center of mass
+	void				ComputeBounds();
+	void				DetectBox(); // Must be centered on center of mass
+
+	EShapeType			m_type;
+	float				m_radius;
+
+	TShapeArray<Vec2>	m_points;
+	TShapeArray<Vec2>	m_normals;
+	TShapeArray<Line>	m_lines;
+
+	float				m_signedArea;
+	float				m_localInertiaTensor;
+
+	bool				m_isBox = false;
+	Vec2				m_boxAxis;
+	Vec2				m_boxHalfExtents;
+
+	Vec2				m_centroid;
+	AABB				m_localBounds;
+	float				m_boundingRadius;
+
+	std::vector<std::shared_ptr<const CShape>>	m_children;
+	CAABBTree									m_childTree; // over the children bounds
+};
+
+typedef std::shared_ptr<const CShape>	CShapePtr;
+
+#endif
@@ -0,0 +1,207 @@
+#define _CRT_SECURE_NO_WARNINGS
+#include "SoftwareRenderBackend.h"
+
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+
+#include "Maths.h"
+#include "PolygonBatch.h"
+
+namespace
+{
+	uint8_t	ToByte(float c)
+	{
+		return (uint8_t)(Clamp(c, 0.0f, 1.0f) * 255.0f + 0.5f);
+	}
+
+	// Liang-Barsky, false when the segment is fully outside [0, maxX]x[0, maxY]
+	bool	ClipSegment(float& x0, float& y0, float& x1, float& y1, float maxX, float maxY)
+	{
+		float dx = x1 - x0;
+		float dy = y1 - y0;
+		float p[4] = { -dx, dx, -dy, dy };
+		float q[4] = { x0, maxX - x0, y0, maxY - y0 };
+		float tMin = 0.0f;
+		float tMax = 1.0f;
+
+		for (int i = 0; i < 4; ++i)
+		{
+			if (p[i] == 0.0f)
+			{
+				if (q[i] < 0.0f)
+				{
+					return false;
+				}
+				continue;
+			}
+
+			float t = q[i] / p[i];
+			if (p[i] < 0.0f)
+			{
+				tMin = Max(tMin, t);
+			}
+			else
+			{
+				tMax = Min(tMax, t);
+			}
+		}
+
+		if (tMin > tMax)
+		{
+			return false;
+		}
+
+		x1 = x0 + dx * tMax;
+		y1 = y0 + dy * tMax;
+		x0 = x0 + dx * tMin;
+		y0 = y0 + dy * tMin;
+		return true;
+	}
+}
+
+void	CSoftwareRenderBackend::Init()
+{
+}
+
+void	CSoftwareRenderBackend::Reshape(int width, int height)
+{
+	m_width = Max(width, 1);
+	m_height = Max(height, 1);
+	m_pixels.resize(3 * (size_t)m_width * (size_t)m_height);
+}
+
+void	CSoftwareRenderBackend::BeginFrame(float worldWidth, float worldHeight)
+{
+	m_worldWidth = worldWidth;
+	m_worldHeight = worldHeight;
+
+	// Same clear color as the OpenGL backend
+	uint8_t clear = ToByte(0.05f);
+	std::fill(m_pixels.begin(), m_pixels.end(), clear);
+}
+
+void	CSoftwareRenderBackend::EndFrame()
+{
+}
+
+void	CSoftwareRenderBackend::DrawPolygonBatch(const CPolygonBatch& batch, float r, float g, float b)
+{
+	const std::vector<Vec2>& vertices = batch.GetVertices();
+	const uint32_t* indices = batch.GetIndices();
+	uint8_t cr = ToByte(r), cg = ToByte(g), cb = ToByte(b);
+
+	for (size_t i = 0; i + 1 < batch.GetIndexCount(); i += 2)
+	{
+		float x0, y0, x1, y1;
+		WorldToPixel(vertices[indices[i]].x, vertices[indices[i]].y, x0, y0);
+		WorldToPixel(vertices[indices[i + 1]].x, vertices[indices[i + 1]].y, x1, y1);
+		DrawLine(x0, y0, x1, y1, cr, cg, cb);
+	}
+}
+
+void	CSoftwareRenderBackend::DrawPoints(const float* positionsX, const float* positionsY, size_t count, float radius, float r, float g, float b)
+{
+	uint8_t cr = ToByte(r), cg = ToByte(g), cb = ToByte(b);
+	float pixelRadius = Max(radius * (float)m_height / m_worldHeight, 0.5f);
+	int extent = (int)ceilf(pixelRadius);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		float px, py;
+		WorldToPixel(positionsX[i], positionsY[i], px, py);
+		int cx = (int)floorf(px);
+		int cy = (int)floorf(py);
+
+		for (int y = cy - extent; y <= cy + extent; ++y)
+		{
+			for (int x = cx - extent; x <= cx + extent; ++x)
+			{
+				float dx = (float)x + 0.5f - px;
+				float dy = (float)y + 0.5f - py;
+				if (dx * dx + dy * dy <= pixelRadius * pixelRadius)
+				{
+					SetPixel(x, y, cr, cg, cb);
+				}
+			}
+		}
+	}
+}
+
+void	CSoftwareRenderBackend::DrawLines(const SDebugVertex* vertices, size_t vertexCount)
+{
+	for (size_t i = 0; i + 1 < vertexCount; i += 2)
+	{
+		const SDebugVertex& from = vertices[i];
+		const SDebugVertex& to = vertices[i + 1];
+
+		float x0, y0, x1, y1;
+		WorldToPixel(from.x, from.y, x0, y0);
+		WorldToPixel(to.x, to.y, x1, y1);
+		DrawLine(x0, y0, x1, y1, ToByte(from.r), ToByte(from.g), ToByte(from.b));
+	}
+}
+
+void	CSoftwareRenderBackend::DrawTexts(const std::vector<SRenderText>& texts)
+{
+}
+
+bool	CSoftwareRenderBackend::SaveFrame(const std::string& filename) const
+{
+	FILE* file = fopen(filename.c_str(), "wb");
+	if (!file)
+	{
+		return false;
+	}
+
+	fprintf(file, "P6\n%d %d\n255\n", m_width, m_height);
+	size_t written = fwrite(m_pixels.data(), 1, m_pixels.size(), file);
+	fclose(file);
+
+	return written == m_pixels.size();
+}
+
+void	CSoftwareRenderBackend::WorldToPixel(float x, float y, float& px, float& py) const
+{
+	// Rows go from top to bottom
+	px = (x / m_worldWidth + 0.5f) * (float)m_width;
+	py = (0.5f - y / m_worldHeight) * (float)m_height;
+}
+
+void	CSoftwareRenderBackend::DrawLine(float x0, float y0, float x1, float y1, uint8_t r, uint8_t g, uint8_t b)
+{
+	if (!ClipSegment(x0, y0, x1, y1, (float)m_width, (float)m_height))
+	{
+		return;
+	}
+
+	// DDA, one pixel per step along the major axis
+	float dx = x1 - x0;
+	float dy = y1 - y0;
+	int steps = (int)ceilf(Max(fabsf(dx), fabsf(dy)));
+	if (steps == 0)
+	{
+		SetPixel((int)x0, (int)y0, r, g, b);
+		return;
+	}
+
+	float stepX = dx / (float)steps;
+	float stepY = dy / (float)steps;
+	for (int i = 0; i <= steps; ++i)
+	{
+		SetPixel((int)floorf(x0 + stepX * (float)i), (int)floorf(y0 + stepY * (float)i), r, g, b);
+	}
+}
+
+void	CSoftwareRenderBackend::SetPixel(int x, int y, uint8_t r, uint8_t g, uint8_t b)
+{
+	if (x < 0 || y < 0 || x >= m_width || y >= m_height)
+	{
+		return;
+	}
+
+	uint8_t* pixel = &m_pixels[3 * ((size_t)y * (size_t)m_width + (size_t)x)];
+	pixel[0] = r;
+	pixel[1] = g;
+	pixel[2] = b;
+}
@@ -0,0 +1,45 @@
+#ifndef _SOFTWARE_RENDER_BACKEND_H_
+#define _SOFTWARE_RENDER_BACKEND_H_
+
+#include <stdint.h>
+
+#include "RenderBackend.h"
+
+// Rasterize on the CPU into an RGB framebuffer, no window or GPU needed
+// Frames can be written as binary PPM to be compared between runs
+class CSoftwareRenderBackend : public IRenderBackend
+{
+public:
+	virtual void	Init() override;
+	virtual void	Reshape(int width, int height) override;
+
+	virtual void	BeginFrame(float worldWidth, float worldHeight) override;
+	virtual void	EndFrame() override;
+
+	virtual void	DrawPolygonBatch(const CPolygonBatch& batch, float r, float g, float b) override;
+	virtual void	DrawPoints(const float* positionsX, const float* positionsY, size_t count, float radius, float r, float g, float b) override;
+	virtual void	DrawLines(const SDebugVertex* vertices, size_t vertexCount) override;
+	// Texts are skipped, they hold timings that would differ on every run
+	virtual void	DrawTexts(const std::vector<SRenderText>& texts) override;
+
+	int				GetWidth() const	{ return m_width; }
+	int				GetHeight() const	{ return m_height; }
+	// Rows from top to bottom, 3 bytes per pixel
+	const uint8_t*	GetPixels() const	{ return m_pixels.data(); }
+
+	bool			SaveFrame(const std::string& filename) const;
+
+private:
+	void	WorldToPixel(float x, float y, float& px, float& py) const;
+	void	DrawLine(float x0, float y0, float x1, float y1, uint8_t r, uint8_t g, uint8_t b);
+	void	SetPixel(int x, int y, uint8_t r, uint8_t g, uint8_t b);
+
+	int		m_width = 0;
+	int		m_height = 0;
+	float	m_worldWidth = 1.0f;
+	float	m_worldHeight = 1.0f;
+
+	std::vector<uint8_t>	m_pixels;
+};
+
+#endif
@@ -0,0 +1,115 @@
+#include "StreamBuffer.h"
+
+#include <string.h>
+
+#define STREAM_BUFFER_MIN_SIZE	(64 * 1024)
+
+CStreamBuffer::CStreamBuffer(GLenum target)
+	: m_target(target)
+{
+}
+
+CStreamBuffer::~CStreamBuffer()
+{
+	Release();
+}
+
+size_t	CStreamBuffer::Upload(const void* data, size_t size)
+{
+	if (m_bufferId == 0 || size > m_regionSize)
+	{
+		size_t regionSize = (m_regionSize > 0) ? m_regionSize : STREAM_BUFFER_MIN_SIZE;
+		while (regionSize < size)
+		{
+			regionSize *= 2;
+		}
+		Allocate(regionSize);
+	}
+
+	glBindBuffer(m_target, m_bufferId);
+
+	if (!m_persistent)
+	{
+		glBufferData(m_target, m_regionSize, nullptr, GL_STREAM_DRAW);
+		glBufferSubData(m_target, 0, size, data);
+		return 0;
+	}
+
+	// Wait for the GPU to be done with this region, STREAM_BUFFER_REGIONS frames ago
+	GLsync& fence = m_fences[m_region];
+	if (fence)
+	{
+		while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED)
+		{
+		}
+		glDeleteSync(fence);
+		fence = nullptr;
+	}
+
+	size_t offset = m_region * m_regionSize;
+	memcpy(m_mapped + offset, data, size);
+	return offset;
+}
+
+void	CStreamBuffer::EndFrame()
+{
+	if (m_persistent && m_bufferId != 0)
+	{
+		m_fences[m_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		m_region = (m_region + 1) % STREAM_BUFFER_REGIONS;
+	}
+}
+
+void	CStreamBuffer::Allocate(size_t regionSize)
+{
+	Release();
+
+	m_regionSize = regionSize;
+	m_persistent = (GLEW_ARB_buffer_storage != GL_FALSE);
+
+	glGenBuffers(1, &m_bufferId);
+	glBindBuffer(m_target, m_bufferId);
+
+	if (m_persistent)
+	{
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(m_target, m_regionSize * STREAM_BUFFER_REGIONS, nullptr, flags);
+		m_mapped = (char*)glMapBufferRange(m_target, 0, m_regionSize * STREAM_BUFFER_REGIONS, flags);
+		m_persistent = (m_mapped != nullptr);
+	}
+
+	if (!m_persistent)
+	{
+		glBufferData(m_target, m_regionSize, nullptr, GL_STREAM_DRAW);
+	}
+
+	glBindBuffer(m_target, 0);
+}
+
+void	CStreamBuffer::Release()
+{
+	for (GLsync& fence : m_fences)
+	{
+		if (fence)
+		{
+			glDeleteSync(fence);
+			fence = nullptr;
+		}
+	}
+
+	if (m_bufferId != 0)
+	{
+		if (m_mapped)
+		{
+			glBindBuffer(m_target, m_bufferId);
+			glUnmapBuffer(m_target);
+			glBindBuffer(m_target, 0);
+			m_mapped = nullptr;
+		}
+
+		glDeleteBuffers(1, &m_bufferId);
+		m_bufferId = 0;
+	}
+
+	m_region = 0;
+}
@@ -0,0 +1,41 @@
+#ifndef _STREAM_BUFFER_H_
+#define _STREAM_BUFFER_H_
+
+#include <GL/glew.h>
+
+// Regions of the persistent buffer, the CPU writes one while the GPU may still read the others
+#define STREAM_BUFFER_REGIONS	3
+
+// GPU buffer rewritten by the CPU every frame
+// With GL_ARB_buffer_storage, one buffer stays mapped and is split in STREAM_BUFFER_REGIONS regions guarded by fences
+// Otherwise the storage is orphaned with glBufferData and filled with glBufferSubData
+class CStreamBuffer
+{
+public:
+	CStreamBuffer(GLenum target);
+	~CStreamBuffer();
+
+	CStreamBuffer(const CStreamBuffer&) = delete;
+	CStreamBuffer& operator=(const CStreamBuffer&) = delete;
+
+	// Copy data to the current region and leave the buffer bound, returns the byte offset of the data in the buffer
+	size_t	Upload(const void* data, size_t size);
+
+	// Call once the draws using the current region are issued
+	void	EndFrame();
+
+private:
+	void	Allocate(size_t regionSize);
+	void	Release();
+
+	GLenum	m_target;
+	GLuint	m_bufferId = 0;
+	bool	m_persistent = false;
+
+	size_t	m_regionSize = 0;
+	size_t	m_region = 0;
+	char*	m_mapped = nullptr;
+	GLsync	m_fences[STREAM_BUFFER_REGIONS] = {};
+};
+
+#endif
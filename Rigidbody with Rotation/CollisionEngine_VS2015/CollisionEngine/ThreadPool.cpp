@@ -0,0 +1,136 @@
+#include "ThreadPool.h"
+
+CThreadPool::CThreadPool(size_t workerCount)
+	: m_nextIndex(0), m_running(false)
+{
+	if (workerCount == 0)
+	{
+		size_t hardwareThreads = std::thread::hardware_concurrency();
+		workerCount = (hardwareThreads > 1) ? hardwareThreads - 1 : 0;
+	}
+
+	for (size_t i = 0; i < workerCount; ++i)
+	{
+		m_workers.push_back(std::thread(&CThreadPool::WorkerLoop, this));
+	}
+}
+
+CThreadPool::~CThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_jobCondition.notify_all();
+
+	for (std::thread& worker : m_workers)
+	{
+		worker.join();
+	}
+}
+
+size_t	CThreadPool::GetThreadCount() const
+{
+	return m_workers.size() + 1;
+}
+
+void	CThreadPool::Run(size_t count, size_t chunkSize, const SJob& job)
+{
+	chunkSize = (chunkSize > 0) ? chunkSize : 1;
+
+	bool expected = false;
+	if (m_workers.empty() || count <= chunkSize || !m_running.compare_exchange_strong(expected, true))
+	{
+		for (size_t begin = 0; begin < count; begin += chunkSize)
+		{
+			job.invoke(job.functor, begin, (begin + chunkSize < count) ? begin + chunkSize : count);
+		}
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_job = job;
+		m_count = count;
+		m_chunkSize = chunkSize;
+		m_nextIndex = 0;
+		m_busyWorkers = m_workers.size();
+		++m_jobId;
+	}
+	m_jobCondition.notify_all();
+
+	RunChunks();
+
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_doneCondition.wait(lock, [&]() { return m_busyWorkers == 0; });
+		m_job = SJob();
+	}
+
+	m_running = false;
+}
+
+bool	CThreadPool::Assist(float waitTime)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	if (!m_jobCondition.wait_for(lock, std::chrono::duration<float>(waitTime), [&]() { return m_stop || HasChunksLeft(); }) || m_stop)
+	{
+		return false;
+	}
+
+	// Counted as a worker, so Run does not return before our chunks are done
+	++m_busyWorkers;
+	lock.unlock();
+	RunChunks();
+	lock.lock();
+
+	if (--m_busyWorkers == 0)
+	{
+		m_doneCondition.notify_one();
+	}
+	return true;
+}
+
+void	CThreadPool::WorkerLoop()
+{
+	size_t lastJobId = 0;
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true)
+	{
+		m_jobCondition.wait(lock, [&]() { return m_stop || m_jobId != lastJobId; });
+		if (m_stop)
+		{
+			break;
+		}
+		lastJobId = m_jobId;
+
+		lock.unlock();
+		RunChunks();
+		lock.lock();
+
+		if (--m_busyWorkers == 0)
+		{
+			m_doneCondition.notify_one();
+		}
+	}
+}
+
+bool	CThreadPool::HasChunksLeft() const
+{
+	return m_job.invoke != nullptr && m_nextIndex < m_count;
+}
+
+void	CThreadPool::RunChunks()
+{
+	while (true)
+	{
+		size_t begin = m_nextIndex.fetch_add(m_chunkSize);
+		if (begin >= m_count)
+		{
+			break;
+		}
+
+		m_job.invoke(m_job.functor, begin, (begin + m_chunkSize < m_count) ? begin + m_chunkSize : m_count);
+	}
+}
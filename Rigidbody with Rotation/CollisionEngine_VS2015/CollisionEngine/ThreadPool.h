@@ -0,0 +1,77 @@
+#ifndef _THREAD_POOL_H_
+#define _THREAD_POOL_H_
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+
+// Fixed set of worker threads running one ParallelFor at a time
+class CThreadPool
+{
+public:
+	// 0 : one worker per hardware thread, minus the calling thread
+	CThreadPool(size_t workerCount = 0);
+	~CThreadPool();
+
+	CThreadPool(const CThreadPool&) = delete;
+	CThreadPool& operator=(const CThreadPool&) = delete;
+
+	// Workers plus the calling thread
+	size_t	GetThreadCount() const;
+
+	// Split [0, count) in chunks of chunkSize and call functor(begin, end) for each, on workers and the calling thread
+	// Returns once every chunk is done. Calls made from inside a job run on the calling thread only
+	// functor is only referenced, no std::function is built so nothing is allocated
+	template<typename TFunctor>
+	void	ParallelFor(size_t count, size_t chunkSize, const TFunctor& functor)
+	{
+		SJob job;
+		job.invoke = &InvokeJob<TFunctor>;
+		job.functor = &functor;
+		Run(count, chunkSize, job);
+	}
+
+	// Lend the calling thread to the pool for at most waitTime seconds : it sleeps until a ParallelFor has chunks left,
+	// then runs them like a worker. Returns true if it ran some, false if nothing came before waitTime
+	// For threads outside the pool that would otherwise sleep (see CFramePacer::SetIdleJob)
+	bool	Assist(float waitTime);
+
+private:
+	struct SJob
+	{
+		void		(*invoke)(const void* functor, size_t begin, size_t end) = nullptr;
+		const void*	functor = nullptr;
+	};
+
+	template<typename TFunctor>
+	static void	InvokeJob(const void* functor, size_t begin, size_t end)
+	{
+		(*static_cast<const TFunctor*>(functor))(begin, end);
+	}
+
+	void	Run(size_t count, size_t chunkSize, const SJob& job);
+	void	WorkerLoop();
+	void	RunChunks();
+	bool	HasChunksLeft() const; // under m_mutex
+
+	std::vector<std::thread>	m_workers;
+
+	std::mutex					m_mutex;
+	std::condition_variable		m_jobCondition;
+	std::condition_variable		m_doneCondition;
+	bool						m_stop = false;
+	size_t						m_jobId = 0;
+	size_t						m_busyWorkers = 0;
+
+	// Current job, only written while no worker is busy
+	SJob						m_job;
+	size_t						m_count = 0;
+	size_t						m_chunkSize = 1;
+	std::atomic<size_t>			m_nextIndex;
+	std::atomic<bool>			m_running;
+};
+
+#endif
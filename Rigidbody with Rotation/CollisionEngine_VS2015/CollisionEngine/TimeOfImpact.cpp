@@ -0,0 +1,200 @@
+#include "TimeOfImpact.h"
+
+#include <cfloat>
+
+#include "Geometry.h"
+#include "GlobalVariables.h"
+#include "PhysicEngine.h"
+
+void	SSweep::GetPose(float t, Vec2& position, Mat2& rotation) const
+{
+	position = startPosition + translation * t;
+	rotation = startRotation;
+	rotation.Rotate(this->rotation * t);
+}
+
+SSweep	MakeStillSweep(const CPolygonPtr& polygon)
+{
+	SSweep sweep;
+	sweep.polygon = polygon;
+	sweep.startPosition = polygon->position;
+	sweep.startRotation = polygon->rotation;
+	return sweep;
+}
+
+// Closest point of segment [a, b] to point
+static Vec2 ClosestPointOnSegment(const Vec2& a, const Vec2& b, const Vec2& point)
+{
+	Vec2 ab = b - a;
+	float sqrLength = ab.GetSqrLength();
+	if (sqrLength <= 0.0f)
+	{
+		return a;
+	}
+
+	float t = Clamp(((point - a) | ab) / sqrLength, 0.0f, 1.0f);
+	return a + ab * t;
+}
+
+// Separating axis over the edge normals of both sets, a single point has no edge
+static bool AreSeparated(const Vec2* pointsA, size_t countA, const Vec2* pointsB, size_t countB)
+{
+	for (size_t set = 0; set < 2; ++set)
+	{
+		const Vec2* edgePoints = (set == 0) ? pointsA : pointsB;
+		size_t edgeCount = (set == 0) ? countA : countB;
+		if (edgeCount < 2)
+		{
+			continue;
+		}
+
+		for (size_t i = 0; i < edgeCount; ++i)
+		{
+			Vec2 axis = (edgePoints[(i + 1) % edgeCount] - edgePoints[i]).GetNormal();
+
+			float minA = FLT_MAX, maxA = -FLT_MAX, minB = FLT_MAX, maxB = -FLT_MAX;
+			for (size_t j = 0; j < countA; ++j)
+			{
+				float projection = pointsA[j] | axis;
+				minA = Min(minA, projection);
+				maxA = Max(maxA, projection);
+			}
+			for (size_t j = 0; j < countB; ++j)
+			{
+				float projection = pointsB[j] | axis;
+				minB = Min(minB, projection);
+				maxB = Max(maxB, projection);
+			}
+
+			if (maxA < minB || maxB < minA)
+			{
+				return true;
+			}
+		}
+	}
+
+	return (countA >= 2 || countB >= 2) ? false : (pointsA[0] - pointsB[0]).GetSqrLength() > 0.0f;
+}
+
+float	ConvexDistance(const Vec2* pointsA, size_t countA, float radiusA, const Vec2* pointsB, size_t countB, float radiusB, Vec2& normal)
+{
+	normal = Vec2();
+	if (!AreSeparated(pointsA, countA, pointsB, countB))
+	{
+		return 0.0f;
+	}
+
+	// Separated convex sets : the closest points are a vertex of one and a point of an edge of the other
+	float bestSqrDistance = FLT_MAX;
+	Vec2 bestA, bestB;
+	for (size_t set = 0; set < 2; ++set)
+	{
+		const Vec2* vertices = (set == 0) ? pointsA : pointsB;
+		size_t vertexCount = (set == 0) ? countA : countB;
+		const Vec2* edgePoints = (set == 0) ? pointsB : pointsA;
+		size_t edgeCount = (set == 0) ? countB : countA;
+
+		for (size_t i = 0; i < vertexCount; ++i)
+		{
+			for (size_t j = 0; j < edgeCount; ++j)
+			{
+				Vec2 closest = (edgeCount < 2) ? edgePoints[0] : ClosestPointOnSegment(edgePoints[j], edgePoints[(j + 1) % edgeCount], vertices[i]);
+				float sqrDistance = (closest - vertices[i]).GetSqrLength();
+				if (sqrDistance < bestSqrDistance)
+				{
+					bestSqrDistance = sqrDistance;
+					bestA = (set == 0) ? vertices[i] : closest;
+					bestB = (set == 0) ? closest : vertices[i];
+				}
+			}
+		}
+	}
+
+	float distance = sqrtf(bestSqrDistance);
+	if (distance > 0.0f)
+	{
+		normal = (bestB - bestA) * (1.0f / distance);
+	}
+
+	return Max(distance - radiusA - radiusB, 0.0f);
+}
+
+// World points of the polygon at pose, circles are only their center
+static void GetSweepPoints(const SSweep& sweep, float t, TFrameVector<Vec2>& points, float& radius)
+{
+	Vec2 position;
+	Mat2 rotation;
+	sweep.GetPose(t, position, rotation);
+
+	const CPolygon& polygon = *sweep.polygon;
+	if (polygon.IsCircle())
+	{
+		points.assign(1, position);
+		radius = polygon.GetShape()->GetRadius();
+		return;
+	}
+
+	const TShapeArray<Vec2>& localPoints = polygon.GetShape()->GetPoints();
+	points.resize(localPoints.size());
+	for (size_t i = 0; i < localPoints.size(); ++i)
+	{
+		points[i] = position + rotation * localPoints[i];
+	}
+	radius = 0.0f;
+
+	// Never further than the concave outline, so the advancement stays conservative
+	if (polygon.IsCompound())
+	{
+		TFrameVector<Vec2> hull(2 * points.size(), Vec2(), points.get_allocator());
+		hull.resize(ComputeConvexHull(points.data(), points.size(), hull.data()));
+		points.swap(hull);
+	}
+}
+
+bool	ComputeTimeOfImpact(const SSweep& sweepA, const SSweep& sweepB, float& toi, Vec2& normal)
+{
+	// Points move at most by the translation plus the rotation arc at the bounding radius
+	float angularBound = fabsf(DEG2RAD(sweepA.rotation)) * sweepA.polygon->GetShape()->GetBoundingRadius()
+		+ fabsf(DEG2RAD(sweepB.rotation)) * sweepB.polygon->GetShape()->GetBoundingRadius();
+	Vec2 relativeTranslation = sweepA.translation - sweepB.translation;
+
+	CFrameArena& arena = gVars->pPhysicEngine->GetFrameArena();
+	TFrameVector<Vec2> pointsA(arena), pointsB(arena);
+	float radiusA, radiusB;
+
+	float t = 0.0f;
+	for (size_t iteration = 0; iteration < TOI_MAX_ITERATIONS; ++iteration)
+	{
+		GetSweepPoints(sweepA, t, pointsA, radiusA);
+		GetSweepPoints(sweepB, t, pointsB, radiusB);
+
+		float distance = ConvexDistance(pointsA.data(), pointsA.size(), radiusA, pointsB.data(), pointsB.size(), radiusB, normal);
+		if (distance <= TOI_TOLERANCE)
+		{
+			// Already overlapping or moving apart from a contact, left to the discrete narrow phase
+			if (t == 0.0f && (distance <= 0.0f || (relativeTranslation | normal) <= 0.0f))
+			{
+				return false;
+			}
+
+			toi = t;
+			return true;
+		}
+
+		float approachBound = (relativeTranslation | normal) + angularBound;
+		if (approachBound <= 0.0f)
+		{
+			return false;
+		}
+
+		t += (distance - TOI_TOLERANCE * 0.5f) / approachBound;
+		if (t > 1.0f)
+		{
+			return false;
+		}
+	}
+
+	// Not converged, still a safe time
+	toi = t;
+	return true;
+}
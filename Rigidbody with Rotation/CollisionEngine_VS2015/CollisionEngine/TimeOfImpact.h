@@ -0,0 +1,34 @@
+#ifndef _TIME_OF_IMPACT_H_
+#define _TIME_OF_IMPACT_H_
+
+#include "Polygon.h"
+
+// Shapes closer than this are considered touching
+#define TOI_TOLERANCE		0.005f
+#define TOI_MAX_ITERATIONS	20
+
+// Motion of a polygon over one step, from its start pose to its current one
+struct SSweep
+{
+	CPolygonPtr	polygon;
+	Vec2		startPosition;
+	Mat2		startRotation;
+	Vec2		translation;
+	float		rotation = 0.0f; // degrees
+
+	// Pose at t in [0, 1]
+	void	GetPose(float t, Vec2& position, Mat2& rotation) const;
+};
+
+// Polygon whose pose does not change over the step
+SSweep	MakeStillSweep(const CPolygonPtr& polygon);
+
+// Closest distance between two convex point sets, inflated by radius (circles are a center and a radius)
+// normal goes from A to B, distance is 0 when they overlap
+float	ConvexDistance(const Vec2* pointsA, size_t countA, float radiusA, const Vec2* pointsB, size_t countB, float radiusB, Vec2& normal);
+
+// Conservative advancement : step forward by the distance over the bound of the approach speed until the shapes touch
+// False if they never get closer than TOI_TOLERANCE during the step, or already overlap at its start
+bool	ComputeTimeOfImpact(const SSweep& sweepA, const SSweep& sweepB, float& toi, Vec2& normal);
+
+#endif
@@ -0,0 +1,280 @@
+#define _CRT_SECURE_NO_WARNINGS // fopen
+
+#include "TrajectoryRecorder.h"
+
+#include <string.h>
+
+#include "GlobalVariables.h"
+#include "World.h"
+
+// Front buffer is handed to the writer once it holds this many values
+#define TRAJECTORY_FLUSH_SIZE	(1 << 16)
+
+static const char TRAJECTORY_MAGIC[4] = { 'T', 'R', 'J', '1' };
+
+static int32_t Quantize(float value, float step)
+{
+	return (int32_t)floorf(value / step + 0.5f);
+}
+
+static uint32_t ZigZag(int32_t value)
+{
+	return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static int32_t UnZigZag(uint32_t value)
+{
+	return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+static void WriteVarint(std::vector<uint8_t>& out, uint32_t value)
+{
+	while (value >= 0x80)
+	{
+		out.push_back((uint8_t)(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back((uint8_t)value);
+}
+
+CTrajectoryRecorder::~CTrajectoryRecorder()
+{
+	Stop();
+}
+
+bool	CTrajectoryRecorder::Start(const std::string& fileName)
+{
+	Stop();
+
+	m_file = fopen(fileName.c_str(), "wb");
+	if (m_file == nullptr)
+	{
+		return false;
+	}
+	fwrite(TRAJECTORY_MAGIC, 1, sizeof(TRAJECTORY_MAGIC), m_file);
+
+	m_frontSteps.clear();
+	m_backSteps.clear();
+	m_previousStep.clear();
+	m_backPending = false;
+	m_stopWriter = false;
+
+	m_writerThread = std::thread(&CTrajectoryRecorder::WriterLoop, this);
+	return true;
+}
+
+void	CTrajectoryRecorder::Stop()
+{
+	if (m_file == nullptr)
+	{
+		return;
+	}
+
+	{
+		// Wait for the writer to drain the back buffer, then hand it what remains
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_condition.wait(lock, [&]() { return !m_backPending; });
+
+		std::swap(m_frontSteps, m_backSteps);
+		m_backPending = !m_backSteps.empty();
+		m_stopWriter = true;
+	}
+	m_condition.notify_all();
+	m_writerThread.join();
+
+	fclose(m_file);
+	m_file = nullptr;
+}
+
+bool	CTrajectoryRecorder::IsRecording() const
+{
+	return m_file != nullptr;
+}
+
+void	CTrajectoryRecorder::RecordStep(float deltaTime)
+{
+	if (m_file == nullptr)
+	{
+		return;
+	}
+
+	m_frontSteps.push_back((int32_t)gVars->pWorld->GetPolygonCount());
+	m_frontSteps.push_back(Quantize(deltaTime, TRAJECTORY_TIME_STEP));
+
+	gVars->pWorld->ForEachPolygon([&](CPolygonPtr poly)
+	{
+		m_frontSteps.push_back(Quantize(poly->position.x, TRAJECTORY_POSITION_STEP));
+		m_frontSteps.push_back(Quantize(poly->position.y, TRAJECTORY_POSITION_STEP));
+		m_frontSteps.push_back(Quantize(atan2f(poly->rotation.X.y, poly->rotation.X.x), TRAJECTORY_ANGLE_STEP));
+		m_frontSteps.push_back(Quantize(poly->speed.x, TRAJECTORY_SPEED_STEP));
+		m_frontSteps.push_back(Quantize(poly->speed.y, TRAJECTORY_SPEED_STEP));
+	});
+
+	if (m_frontSteps.size() < TRAJECTORY_FLUSH_SIZE)
+	{
+		return;
+	}
+
+	// If the writer is still busy, keep filling the front buffer instead of waiting
+	bool swapped = false;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (!m_backPending)
+		{
+			std::swap(m_frontSteps, m_backSteps);
+			m_backPending = true;
+			swapped = true;
+		}
+	}
+
+	if (swapped)
+	{
+		m_condition.notify_all();
+	}
+}
+
+void	CTrajectoryRecorder::WriterLoop()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true)
+	{
+		m_condition.wait(lock, [&]() { return m_backPending || m_stopWriter; });
+
+		if (m_backPending)
+		{
+			// Back buffer is not touched by the simulation while pending
+			lock.unlock();
+
+			EncodeSteps(m_backSteps);
+			fwrite(m_encoded.data(), 1, m_encoded.size(), m_file);
+			m_backSteps.clear();
+
+			lock.lock();
+			m_backPending = false;
+			m_condition.notify_all();
+		}
+		else if (m_stopWriter)
+		{
+			break;
+		}
+	}
+}
+
+void	CTrajectoryRecorder::EncodeSteps(const std::vector<int32_t>& steps)
+{
+	m_encoded.clear();
+
+	size_t cursor = 0;
+	while (cursor + 2 <= steps.size())
+	{
+		size_t valueCount = (size_t)steps[cursor] * 5;
+		WriteVarint(m_encoded, (uint32_t)steps[cursor]);
+		WriteVarint(m_encoded, (uint32_t)steps[cursor + 1]);
+		cursor += 2;
+
+		if (m_previousStep.size() < valueCount)
+		{
+			m_previousStep.resize(valueCount, 0);
+		}
+
+		for (size_t i = 0; i < valueCount; ++i)
+		{
+			int32_t value = steps[cursor + i];
+			WriteVarint(m_encoded, ZigZag((int32_t)((uint32_t)value - (uint32_t)m_previousStep[i])));
+			m_previousStep[i] = value;
+		}
+		cursor += valueCount;
+	}
+}
+
+CTrajectoryReader::~CTrajectoryReader()
+{
+	Close();
+}
+
+bool	CTrajectoryReader::Open(const std::string& fileName)
+{
+	Close();
+
+	m_file = fopen(fileName.c_str(), "rb");
+	if (m_file == nullptr)
+	{
+		return false;
+	}
+
+	char magic[4];
+	if (fread(magic, 1, sizeof(magic), m_file) != sizeof(magic) || memcmp(magic, TRAJECTORY_MAGIC, sizeof(magic)) != 0)
+	{
+		Close();
+		return false;
+	}
+
+	m_previousStep.clear();
+	return true;
+}
+
+void	CTrajectoryReader::Close()
+{
+	if (m_file != nullptr)
+	{
+		fclose(m_file);
+		m_file = nullptr;
+	}
+}
+
+bool	CTrajectoryReader::ReadStep(std::vector<SBodyTransform>& bodies, float& deltaTime)
+{
+	uint32_t bodyCount, time;
+	if (m_file == nullptr || !ReadVarint(bodyCount) || !ReadVarint(time))
+	{
+		return false;
+	}
+	deltaTime = (float)(int32_t)time * TRAJECTORY_TIME_STEP;
+
+	size_t valueCount = (size_t)bodyCount * 5;
+	if (m_previousStep.size() < valueCount)
+	{
+		m_previousStep.resize(valueCount, 0);
+	}
+
+	for (size_t i = 0; i < valueCount; ++i)
+	{
+		uint32_t value;
+		if (!ReadVarint(value))
+		{
+			return false;
+		}
+		m_previousStep[i] = (int32_t)((uint32_t)m_previousStep[i] + (uint32_t)UnZigZag(value));
+	}
+
+	bodies.resize(bodyCount);
+	for (size_t i = 0; i < bodyCount; ++i)
+	{
+		const int32_t* values = &m_previousStep[i * 5];
+		bodies[i].position = Vec2((float)values[0], (float)values[1]) * TRAJECTORY_POSITION_STEP;
+		bodies[i].angle = (float)values[2] * TRAJECTORY_ANGLE_STEP;
+		bodies[i].speed = Vec2((float)values[3], (float)values[4]) * TRAJECTORY_SPEED_STEP;
+	}
+
+	return true;
+}
+
+bool	CTrajectoryReader::ReadVarint(uint32_t& value)
+{
+	value = 0;
+	for (int shift = 0; shift < 35; shift += 7)
+	{
+		int byte = fgetc(m_file);
+		if (byte == EOF)
+		{
+			return false;
+		}
+
+		value |= (uint32_t)(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
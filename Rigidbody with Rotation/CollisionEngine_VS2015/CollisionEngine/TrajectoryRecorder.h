@@ -0,0 +1,81 @@
+#ifndef _TRAJECTORY_RECORDER_H_
+#define _TRAJECTORY_RECORDER_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "Maths.h"
+
+// Quantization steps of the recorded values
+#define TRAJECTORY_POSITION_STEP	(1.0f / 1024.0f)
+#define TRAJECTORY_ANGLE_STEP		(1.0f / 8192.0f) // radians
+#define TRAJECTORY_SPEED_STEP		(1.0f / 512.0f)
+#define TRAJECTORY_TIME_STEP		(1.0f / 1000000.0f) // seconds
+
+struct SBodyTransform
+{
+	Vec2	position;
+	float	angle; // radians
+	Vec2	speed;
+};
+
+// File layout : "TRJ1", then for each step :
+//	varint bodyCount, varint deltaTime (microseconds)
+//	then for each body, 5 zigzag varints : position x, position y, angle, speed x, speed y
+//	each value is the quantized value minus the one of the same body in the previous step (0 for new bodies)
+class CTrajectoryRecorder
+{
+public:
+	~CTrajectoryRecorder();
+
+	bool	Start(const std::string& fileName);
+	void	Stop();
+	bool	IsRecording() const;
+
+	// Quantize the world bodies, encoding and writing is done by the writer thread
+	void	RecordStep(float deltaTime);
+
+private:
+	void	WriterLoop();
+	void	EncodeSteps(const std::vector<int32_t>& steps);
+
+	FILE*					m_file = nullptr;
+	std::thread				m_writerThread;
+
+	// Double buffer : simulation fills front, writer drains back
+	std::vector<int32_t>	m_frontSteps;
+	std::vector<int32_t>	m_backSteps;
+	std::mutex				m_mutex;
+	std::condition_variable	m_condition;
+	bool					m_backPending = false;
+	bool					m_stopWriter = false;
+
+	// Writer thread only
+	std::vector<int32_t>	m_previousStep;
+	std::vector<uint8_t>	m_encoded;
+};
+
+class CTrajectoryReader
+{
+public:
+	~CTrajectoryReader();
+
+	bool	Open(const std::string& fileName);
+	void	Close();
+
+	// Return false when there is no more step in the file
+	bool	ReadStep(std::vector<SBodyTransform>& bodies, float& deltaTime);
+
+private:
+	bool	ReadVarint(uint32_t& value);
+
+	FILE*					m_file = nullptr;
+	std::vector<int32_t>	m_previousStep;
+};
+
+#endif
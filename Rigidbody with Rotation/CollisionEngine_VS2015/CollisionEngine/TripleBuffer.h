@@ -0,0 +1,62 @@
+#ifndef _TRIPLE_BUFFER_H_
+#define _TRIPLE_BUFFER_H_
+
+#include <stdint.h>
+#include <atomic>
+
+// Lock free exchange between one producer thread and one consumer thread
+// The producer always owns a buffer to write and the consumer always reads the latest complete one,
+// the third buffer sits in the middle and is swapped atomically by both sides
+template<typename T>
+class CTripleBuffer
+{
+public:
+	CTripleBuffer()
+		: m_middle(2){}
+
+	CTripleBuffer(const CTripleBuffer&) = delete;
+	CTripleBuffer& operator=(const CTripleBuffer&) = delete;
+
+	// Producer side, holds old data once it has been published before
+	T&	GetWriteBuffer()
+	{
+		return m_buffers[m_writeIndex];
+	}
+
+	// Producer side, the write buffer becomes the latest one
+	void	Publish()
+	{
+		uint32_t previous = m_middle.exchange(m_writeIndex | NEW_DATA_BIT, std::memory_order_acq_rel);
+		m_writeIndex = previous & INDEX_MASK;
+	}
+
+	// Consumer side, switch to the latest published buffer, false when nothing was published since the last call
+	bool	Acquire()
+	{
+		if ((m_middle.load(std::memory_order_relaxed) & NEW_DATA_BIT) == 0)
+		{
+			return false;
+		}
+
+		uint32_t previous = m_middle.exchange(m_readIndex, std::memory_order_acq_rel);
+		m_readIndex = previous & INDEX_MASK;
+		return true;
+	}
+
+	// Consumer side, stays valid until the next Acquire
+	const T&	GetReadBuffer() const
+	{
+		return m_buffers[m_readIndex];
+	}
+
+private:
+	static const uint32_t	INDEX_MASK = 3;
+	static const uint32_t	NEW_DATA_BIT = 4;
+
+	T						m_buffers[3];
+	uint32_t				m_writeIndex = 0;
+	uint32_t				m_readIndex = 1;
+	std::atomic<uint32_t>	m_middle; // index, plus NEW_DATA_BIT until the consumer takes it
+};
+
+#endif
@@ -1,14 +1,156 @@
 #include "World.h"
 
+#include <algorithm>
+#include <cfloat>
+
 #include "Polygon.h"
+#include "GlobalVariables.h"
+#include "ThreadPool.h"
+#include "PhysicEngine.h"
+#include "BroadPhase.h"
+
+// Ray casts per job of RayCastBatch
+#define RAYCAST_BATCH_CHUNK_SIZE	64
+
+namespace
+{
+	void	ProjectPoints(const Vec2* points, size_t count, const Vec2& axis, float& min, float& max)
+	{
+		min = max = points[0] | axis;
+		for (size_t i = 1; i < count; ++i)
+		{
+			float projection = points[i] | axis;
+			min = Min(min, projection);
+			max = Max(max, projection);
+		}
+	}
+
+	Vec2	GetSupportPoint(const Vec2* points, size_t count, const Vec2& direction)
+	{
+		size_t best = 0;
+		float bestProjection = points[0] | direction;
+		for (size_t i = 1; i < count; ++i)
+		{
+			float projection = points[i] | direction;
+			if (projection > bestProjection)
+			{
+				best = i;
+				bestProjection = projection;
+			}
+		}
+		return points[best];
+	}
+
+	// Separating axis test of convex points moved by translation against still convex points, over time
+	// Each edge normal gives the time interval where projections overlap, shapes touch where every interval does
+	// Exact for translations, t is the fraction of translation at first contact
+	bool	SweepConvex(const Vec2* points, size_t count, const Vec2& translation, const Vec2* targetPoints, size_t targetCount, float& t, Vec2& normal, Vec2& contactPoint)
+	{
+		float tEnter = -FLT_MAX;
+		float tExit = FLT_MAX;
+		bool targetAxis = true;
+		normal = Vec2();
+
+		for (size_t shape = 0; shape < 2; ++shape)
+		{
+			const Vec2* edgePoints = (shape == 0) ? targetPoints : points;
+			size_t edgeCount = (shape == 0) ? targetCount : count;
+			if (edgeCount < 2)
+			{
+				continue;
+			}
+
+			for (size_t i = 0; i < edgeCount; ++i)
+			{
+				Vec2 axis = (edgePoints[(i + 1) % edgeCount] - edgePoints[i]).GetNormal();
+
+				float min, max, targetMin, targetMax;
+				ProjectPoints(points, count, axis, min, max);
+				ProjectPoints(targetPoints, targetCount, axis, targetMin, targetMax);
+
+				float speed = translation | axis;
+				if (fabsf(speed) < FLT_EPSILON)
+				{
+					if (max < targetMin || min > targetMax)
+					{
+						return false;
+					}
+					continue;
+				}
+
+				float tLow = (targetMin - max) / speed;
+				float tHigh = (targetMax - min) / speed;
+				if (tLow > tHigh)
+				{
+					std::swap(tLow, tHigh);
+				}
+
+				if (tLow > tEnter)
+				{
+					tEnter = tLow;
+					normal = axis;
+					targetAxis = (shape == 0);
+				}
+				tExit = Min(tExit, tHigh);
+
+				if (tEnter > tExit)
+				{
+					return false;
+				}
+			}
+		}
+
+		if (tExit < 0.0f || tEnter > 1.0f)
+		{
+			return false;
+		}
+
+		t = Max(tEnter, 0.0f);
+		if ((normal | translation) > 0.0f)
+		{
+			normal = normal * -1.0f;
+		}
+		if (normal.GetSqrLength() > 0.0f)
+		{
+			normal.Normalize();
+		}
+
+		// On a target edge the moved point furthest along -normal touches it, otherwise a target vertex does
+		contactPoint = targetAxis ? GetSupportPoint(points, count, normal * -1.0f) + translation * t : GetSupportPoint(targetPoints, targetCount, normal);
+		return true;
+	}
+
+	bool	RayCastCircle(const Vec2& origin, const Vec2& direction, float maxDistance, const Vec2& center, float radius, float& distance)
+	{
+		Vec2 toOrigin = origin - center;
+		float c = (toOrigin | toOrigin) - radius * radius;
+		if (c <= 0.0f)
+		{
+			distance = 0.0f;
+			return true;
+		}
+
+		float b = toOrigin | direction;
+		float discriminant = b * b - c;
+		if (b > 0.0f || discriminant < 0.0f)
+		{
+			return false;
+		}
+
+		distance = -b - sqrtf(discriminant);
+		return distance <= maxDistance;
+	}
+}
 
 CPolygonPtr		CWorld::AddTriangle(float base, float height)
 {
 	CPolygonPtr poly = AddPolygon();
-	poly->points.push_back({ -base * 0.5f, -height * 0.5f });
-	poly->points.push_back({ base * 0.5f, -height * 0.5f });
-	poly->points.push_back({ 0.0f, height * 0.5f });
-	poly->Build();
+	poly->SetShape(GetSharedShape(EShapeKind::Triangle, base, height, [&](std::vector<Vec2>& points)
+	{
+		points.push_back({ -base * 0.5f, -height * 0.5f });
+		points.push_back({ base * 0.5f, -height * 0.5f });
+		points.push_back({ 0.0f, height * 0.5f });
+	}));
 
 	return poly;
 }
@@ -16,11 +158,13 @@ CPolygonPtr		CWorld::AddTriangle(float base, float height)
 CPolygonPtr		CWorld::AddRectangle(float width, float height)
 {
 	CPolygonPtr poly = AddPolygon();
-	poly->points.push_back({ -width * 0.5f, -height * 0.5f });
-	poly->points.push_back({ width * 0.5f, -height * 0.5f });
-	poly->points.push_back({ width * 0.5f, height * 0.5f });
-	poly->points.push_back({ -width * 0.5f, height * 0.5f });
-	poly->Build();
+	poly->SetShape(GetSharedShape(EShapeKind::Rectangle, width, height, [&](std::vector<Vec2>& points)
+	{
+		points.push_back({ -width * 0.5f, -height * 0.5f });
+		points.push_back({ width * 0.5f, -height * 0.5f });
+		points.push_back({ width * 0.5f, height * 0.5f });
+		points.push_back({ -width * 0.5f, height * 0.5f });
+	}));
 
 	return poly;
 }
@@ -33,15 +177,31 @@ CPolygonPtr		CWorld::AddSquare(float size)
 CPolygonPtr		CWorld::AddSymetricPolygon(float radius, size_t sides)
 {
 	CPolygonPtr poly = AddPolygon();
-	float dAngle = 360.0f / (float)sides;
-	for (size_t i = 0; i < sides; ++i)
+	poly->SetShape(GetSharedShape(EShapeKind::Symetric, radius, (float)sides, [&](std::vector<Vec2>& points)
 	{
-		float angle = i * dAngle;
+		float dAngle = 360.0f / (float)sides;
+		for (size_t i = 0; i < sides; ++i)
+		{
+			float angle = i * dAngle;
 
-		Vec2 point = Vec2(cosf(DEG2RAD(angle)), sinf(DEG2RAD(angle))) * radius;
-		poly->points.push_back(point);
+			Vec2 point = Vec2(cosf(DEG2RAD(angle)), sinf(DEG2RAD(angle))) * radius;
+			points.push_back(point);
+		}
+	}));
+
+	return poly;
+}
+
+CPolygonPtr		CWorld::AddCircle(float radius)
+{
+	CShapePtr& shape = m_sharedShapes[std::make_tuple(EShapeKind::Circle, radius, 0.0f)];
+	if (!shape)
+	{
+		shape = std::make_shared<CShape>(radius);
 	}
-	poly->Build();
+
+	CPolygonPtr poly = AddPolygon();
+	poly->SetShape(shape);
 
 	return poly;
 }
@@ -56,7 +216,7 @@ CPolygonPtr		CWorld::AddRandomPoly(const SRandomPolyParams& params)
 	for (size_t i = 0; i < pointsCount; ++i)
 	{
 		float angle = i * dAngle + Random(-dAngle / 3.0f, dAngle / 3.0f);
-		float dist = radius;
+		float dist = radius * (1.0f - Random(0.0f, params.concavity));
 
 		Vec2 point = Vec2(cosf(DEG2RAD(angle)), sinf(DEG2RAD(angle))) * dist;
 		poly->points.push_back(point);
@@ -120,6 +280,185 @@ CPolygonPtr		CWorld::GetPolygon(size_t index)
 	return m_polygons[index];
 }
 
+CPolygonPtr	CWorld::QueryPoint(const Vec2& point) const
+{
+	AABB box;
+	box.Center(point);
+
+	std::vector<CPolygonPtr> candidates;
+	QueryAABB(box, candidates);
+
+	CPolygonPtr found;
+	for (const CPolygonPtr& polygon : candidates)
+	{
+		if ((!found || polygon->GetIndex() > found->GetIndex()) && polygon->IsPointInside(point))
+		{
+			found = polygon;
+		}
+	}
+
+	return found;
+}
+
+void	CWorld::QueryAABB(const AABB& box, std::vector<CPolygonPtr>& polygons) const
+{
+	const IBroadPhase* broadPhase = gVars->pPhysicEngine->GetBroadPhase();
+	if (broadPhase)
+	{
+		broadPhase->QueryAABB(box, polygons);
+	}
+}
+
+bool	CWorld::RayCast(const Vec2& origin, const Vec2& direction, float maxDistance, SRayCastHit& hit) const
+{
+	std::vector<CPolygonPtr> candidates;
+	return RayCast({ origin, direction, maxDistance }, hit, candidates);
+}
+
+bool	CWorld::ShapeCast(const std::vector<Vec2>& points, const Vec2& translation, SRayCastHit& hit, const CPolygon* ignored) const
+{
+	return ShapeCast(points.data(), points.size(), translation, hit, ignored);
+}
+
+bool	CWorld::ShapeCast(const Vec2* points, size_t count, const Vec2& translation, SRayCastHit& hit, const CPolygon* ignored) const
+{
+	hit = SRayCastHit();
+	if (count == 0)
+	{
+		return false;
+	}
+
+	AABB sweptBox;
+	sweptBox.Center(points[0]);
+	for (size_t i = 0; i < count; ++i)
+	{
+		sweptBox.Extend(points[i]);
+		sweptBox.Extend(points[i] + translation);
+	}
+
+	std::vector<CPolygonPtr> candidates;
+	QueryAABB(sweptBox, candidates);
+
+	hit.distance = FLT_MAX;
+	for (const CPolygonPtr& polygon : candidates)
+	{
+		if (polygon.get() == ignored)
+		{
+			continue;
+		}
+
+		polygon->ForEachConvexPart([&](const CPolygon& part)
+		{
+			const TShapeArray<Vec2>& targetPoints = part.GetWorldPoints();
+			float t;
+			Vec2 normal, contactPoint;
+			if (!targetPoints.empty() && SweepConvex(points, count, translation, targetPoints.data(), targetPoints.size(), t, normal, contactPoint) && t < hit.distance)
+			{
+				hit.polygon = polygon;
+				hit.point = contactPoint;
+				hit.normal = normal;
+				hit.distance = t;
+			}
+		});
+	}
+
+	return hit.polygon != nullptr;
+}
+
+bool	CWorld::ShapeCast(const CPolygon& polygon, const Vec2& translation, SRayCastHit& hit) const
+{
+	// Each convex part is cast on its own, the first hit wins
+	hit = SRayCastHit();
+	polygon.ForEachConvexPart([&](const CPolygon& part)
+	{
+		SRayCastHit partHit;
+		const TShapeArray<Vec2>& partPoints = part.GetWorldPoints();
+		if (ShapeCast(partPoints.data(), partPoints.size(), translation, partHit, &polygon) && (!hit.polygon || partHit.distance < hit.distance))
+		{
+			hit = partHit;
+		}
+	});
+	return hit.polygon != nullptr;
+}
+
+void	CWorld::RayCastBatch(const SRayCastQuery* queries, size_t count, SRayCastHit* hits) const
+{
+	gVars->pThreadPool->ParallelFor(count, RAYCAST_BATCH_CHUNK_SIZE, [&](size_t begin, size_t end)
+	{
+		std::vector<CPolygonPtr> candidates;
+		for (size_t i = begin; i < end; ++i)
+		{
+			RayCast(queries[i], hits[i], candidates);
+		}
+	});
+}
+
+bool	CWorld::RayCast(const SRayCastQuery& query, SRayCastHit& hit, std::vector<CPolygonPtr>& candidates) const
+{
+	hit = SRayCastHit();
+
+	Vec2 translation = query.direction * query.maxDistance;
+	AABB rayBox;
+	rayBox.Center(query.origin);
+	rayBox.Extend(query.origin + translation);
+
+	candidates.clear();
+	QueryAABB(rayBox, candidates);
+
+	hit.distance = FLT_MAX;
+	for (const CPolygonPtr& polygon : candidates)
+	{
+		float distance;
+		Vec2 normal, contactPoint;
+
+		if (polygon->IsCircle())
+		{
+			if (!RayCastCircle(query.origin, query.direction, query.maxDistance, polygon->position, polygon->GetShape()->GetRadius(), distance))
+			{
+				continue;
+			}
+			contactPoint = query.origin + query.direction * distance;
+			normal = (distance > 0.0f) ? (contactPoint - polygon->position).Normalized() : query.direction * -1.0f;
+		}
+		else
+		{
+			// Nearest hit over the convex parts
+			float t = FLT_MAX;
+			polygon->ForEachConvexPart([&](const CPolygon& part)
+			{
+				const TShapeArray<Vec2>& targetPoints = part.GetWorldPoints();
+				float partT;
+				Vec2 partNormal, partPoint;
+				if (!targetPoints.empty() && SweepConvex(&query.origin, 1, translation, targetPoints.data(), targetPoints.size(), partT, partNormal, partPoint) && partT < t)
+				{
+					t = partT;
+					normal = partNormal;
+					contactPoint = partPoint;
+				}
+			});
+			if (t == FLT_MAX)
+			{
+				continue;
+			}
+			distance = t * query.maxDistance;
+			if (distance == 0.0f)
+			{
+				normal = query.direction * -1.0f;
+			}
+		}
+
+		if (distance < hit.distance)
+		{
+			hit.polygon = polygon;
+			hit.point = contactPoint;
+			hit.normal = normal;
+			hit.distance = distance;
+		}
+	}
+
+	return hit.polygon != nullptr;
+}
+
 void	CWorld::Update(float frameTime)
 {
 	for(CBehaviorPtr behavior : m_behaviors)
@@ -128,10 +467,33 @@ void	CWorld::Update(float frameTime)
 	}
 }
 
-void	CWorld::RenderPolygons()
+void	CWorld::UpdateTransforms()
+{
+	gVars->pThreadPool->ParallelFor(m_polygons.size(), 256, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+		{
+			m_polygons[i]->UpdateTransform();
+		}
+	});
+}
+
+void	CWorld::FillSnapshot(SRenderSnapshot& snapshot)
 {
+	// Every outline is drawn in one call, from the world points computed by the physic step
 	for (CPolygonPtr polygon : m_polygons)
 	{
-		polygon->Draw();
+		const TShapeArray<Vec2>& worldPoints = polygon->GetWorldPoints();
+		snapshot.polygons.AddOutline(worldPoints.data(), worldPoints.size());
+
+		if (polygon->aabb->bIsDisplayed)
+		{
+			polygon->aabb->RenderBoundingBox();
+		}
+	}
+
+	for (CBehaviorPtr behavior : m_behaviors)
+	{
+		behavior->FillSnapshot(snapshot);
 	}
 }
\ No newline at end of file
@@ -2,9 +2,12 @@
 #define _WORLD_H_
 
 #include <vector>
+#include <map>
+#include <tuple>
 
 #include "Polygon.h"
 #include "Behavior.h"
+#include "RenderSnapshot.h"
 
 struct SRandomPolyParams
 {
@@ -12,6 +15,22 @@ struct SRandomPolyParams
 	float	minRadius, maxRadius;
 	Vec2	minBounds, maxBounds;
 	float	minSpeed, maxSpeed;
+	float	concavity = 0.0f; // up to this fraction of the radius each point can be pulled in by, concave shapes above 0
+};
+
+struct SRayCastHit
+{
+	CPolygonPtr	polygon; // nullptr when nothing is hit
+	Vec2		point;
+	Vec2		normal; // toward the ray origin or the cast shape
+	float		distance = 0.0f; // along the ray, fraction of the translation for shape casts
+};
+
+struct SRayCastQuery
+{
+	Vec2	origin;
+	Vec2	direction; // normalized
+	float	maxDistance;
 };
 
 class CWorld
@@ -21,6 +40,7 @@ public:
 	CPolygonPtr		AddRectangle(float width, float height);
 	CPolygonPtr		AddSquare(float size);
 	CPolygonPtr		AddSymetricPolygon(float radius, size_t sides);
+	CPolygonPtr		AddCircle(float radius);
 	CPolygonPtr		AddRandomPoly(const SRandomPolyParams& params);
 
 	CPolygonPtr		AddPolygon();
@@ -58,12 +78,53 @@ public:
 		}
 	}
 
+	// Queries find polygons from the broad phase of the last physic step
+	// Polygon that contains point, the last added one if several do
+	CPolygonPtr	QueryPoint(const Vec2& point) const;
+	void		QueryAABB(const AABB& box, std::vector<CPolygonPtr>& polygons) const;
+	// Closest hit, a ray starting inside a polygon hits it at distance 0
+	bool		RayCast(const Vec2& origin, const Vec2& direction, float maxDistance, SRayCastHit& hit) const;
+	// Sweep convex world space points along translation, polygons are tested from their outline
+	bool		ShapeCast(const std::vector<Vec2>& points, const Vec2& translation, SRayCastHit& hit, const CPolygon* ignored = nullptr) const;
+	bool		ShapeCast(const Vec2* points, size_t count, const Vec2& translation, SRayCastHit& hit, const CPolygon* ignored = nullptr) const;
+	bool		ShapeCast(const CPolygon& polygon, const Vec2& translation, SRayCastHit& hit) const;
+	// Run on the thread pool, hits[i] is the result of queries[i]
+	void		RayCastBatch(const SRayCastQuery* queries, size_t count, SRayCastHit* hits) const;
+
 	void Update(float frameTime);
-	void RenderPolygons();
+	void UpdateTransforms();
+	// Copy what has to be drawn, called at the end of each physic tick
+	void FillSnapshot(SRenderSnapshot& snapshot);
 
 protected:
+	enum class EShapeKind
+	{
+		Triangle,
+		Rectangle,
+		Symetric,
+		Circle,
+	};
+
+	// Identical polygons share the same shape
+	template<typename TBuilder>
+	CShapePtr	GetSharedShape(EShapeKind kind, float a, float b, TBuilder buildPoints)
+	{
+		CShapePtr& shape = m_sharedShapes[std::make_tuple(kind, a, b)];
+		if (!shape)
+		{
+			std::vector<Vec2> points;
+			buildPoints(points);
+			shape = std::make_shared<CShape>(points);
+		}
+		return shape;
+	}
+
+	bool		RayCast(const SRayCastQuery& query, SRayCastHit& hit, std::vector<CPolygonPtr>& candidates) const;
+
 	std::vector<CPolygonPtr>	m_polygons;
 	std::vector<CBehaviorPtr>	m_behaviors;
+
+	std::map<std::tuple<EShapeKind, float, float>, CShapePtr>	m_sharedShapes;
 };
 
 #endif
\ No newline at end of file
@@ -10,6 +10,8 @@
 
 #include <iostream>
 #include <string>
+#include <stdlib.h>
+#include <string.h>
 
 
 
@@ -22,22 +24,65 @@
 #include "Scenes/SceneSpheres.h"
 #include "Scenes/SceneComplexPhysic.h"
 #include "Scenes/SceneSmallPhysic.h"
+#include "Scenes/SceneFluid.h"
 
 
+/*
+* Command line: -offscreen [-scene index] [-frames count] [-output prefix] [-interval frames]
+* Offscreen runs render with the software backend and print physic / render durations
+*/
+bool ParseOffscreenParams(int argc, char** argv, SOffscreenParams& params)
+{
+	bool offscreen = false;
+	for (int i = 1; i < argc; ++i)
+	{
+		bool hasValue = (i + 1 < argc);
+		if (strcmp(argv[i], "-offscreen") == 0)
+		{
+			offscreen = true;
+		}
+		else if (strcmp(argv[i], "-scene") == 0 && hasValue)
+		{
+			params.sceneIndex = (size_t)atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-frames") == 0 && hasValue)
+		{
+			params.frameCount = (size_t)atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-output") == 0 && hasValue)
+		{
+			params.framePrefix = argv[++i];
+		}
+		else if (strcmp(argv[i], "-interval") == 0 && hasValue)
+		{
+			params.saveInterval = (size_t)atoi(argv[++i]);
+		}
+	}
+
+	return offscreen;
+}
+
 /*
 * Entry point
 */
 int _tmain(int argc, char** argv)
 {
-
-
-	InitApplication(1260, 768, 50.0f);
+	SOffscreenParams offscreenParams;
+	if (ParseOffscreenParams(argc, argv, offscreenParams))
+	{
+		InitOffscreenApplication(1260, 768, 50.0f, offscreenParams);
+	}
+	else
+	{
+		InitApplication(1260, 768, 50.0f);
+	}
 
 	gVars->pSceneManager->AddScene(new CSceneDebugCollisions());
 	gVars->pSceneManager->AddScene(new CSceneSpheres());
 	gVars->pSceneManager->AddScene(new CSceneSmallPhysic());
 	gVars->pSceneManager->AddScene(new CSceneSimplePhysic());
 	gVars->pSceneManager->AddScene(new CSceneComplexPhysic(25));
+	gVars->pSceneManager->AddScene(new CSceneFluid(50000));
 
 
 